@@ -0,0 +1,180 @@
+#define _POSIX_C_SOURCE 200112L // clock_gettime under -std=c99
+#include "../game.h"
+#include "bench.h" // -I../bench
+
+// --- ENTITY BENCHMARKS (v2.1) ---
+// The per-frame systems that scale with entity count: collisions, the spatial
+// index, grass, particles, water, fusion and steering, plus spawn/despawn
+// churn in the entity store. Every sample starts from the same seeded scene.
+
+#define GRASS_OPS 10
+#define PARTICLE_OPS 10
+#define SPLASH_OPS 100
+#define EXPLOSION_OPS 200
+#define CHURN_ENTITIES 100000
+
+static EntityStore store = { .freeHead = -1 };
+static ParticleSystem particles;
+static GrassSystem grass;
+static Player playerData;
+
+// Player in the middle plus n raw earth blobs scattered over the screen
+static void BuildScene(int n) {
+    SetRandomSeed(1234);
+    FreeEntityStore(&store);
+    SpawnEntity(&store, (EntityData){
+        .hot = { .position = { SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 }, .mass = 1.0f, .friction = 10.0f, .size = 30.0f,
+                 .maxSpeed = 600.0f, .moveForce = 3000.0f, .isActive = true, .state = STATE_RAW },
+        .cold = { .color = MAROON, .health = 100, .maxHealth = 100 }
+    });
+    for (int i = 1; i < n; i++) {
+        Vector2 pos = { (float)GetRandomValue(0, SCREEN_WIDTH), (float)GetRandomValue(0, SCREEN_HEIGHT) };
+        SpawnEntity(&store, CreateRawElement(ELEM_EARTH, pos));
+    }
+    InitParticles(&particles);
+    playerData = (Player){ .selectedElement = ELEM_EARTH, .mana = 100, .maxMana = 100 };
+    BuildSpatialIndex(&store);
+}
+
+// --- COLLISIONS ---
+
+static void SetupCollisions(void* ctx) { BuildScene(*(int*)ctx); }
+
+static void RunCollisions(void* ctx) {
+    ResolveEntityCollisions(&store, &particles);
+}
+
+// --- SPATIAL INDEX ---
+
+static void SetupIndex(void* ctx) { BuildScene(*(int*)ctx); }
+
+static void RunIndex(void* ctx) {
+    const int* hits;
+    BuildSpatialIndex(&store);
+    QueryRadius(ENTITY(&store, 0)->position, FUSION_RADIUS, &hits);
+}
+
+// --- GRASS ---
+
+static void SetupGrass(void* ctx) { BuildScene(*(int*)ctx); }
+
+static void RunGrass(void* ctx) {
+    for (int i = 0; i < GRASS_OPS; i++) UpdateGrass(&grass, &store);
+}
+
+// --- PARTICLES ---
+
+static void SetupParticles(void* ctx) {
+    InitParticles(&particles);
+    for (int i = 0; i < MAX_PARTICLES / 50; i++) SpawnExplosion(&particles, (Vector2){ i * 40.0f, 300 }, ORANGE);
+}
+
+static void RunParticles(void* ctx) {
+    for (int i = 0; i < PARTICLE_OPS; i++) UpdateParticles(&particles, 1.0f / 60.0f);
+}
+
+// A burst of explosions in one frame, into an empty system
+static void SetupExplosions(void* ctx) { InitParticles(&particles); }
+
+static void RunExplosions(void* ctx) {
+    for (int i = 0; i < EXPLOSION_OPS; i++) SpawnExplosion(&particles, (Vector2){ i * 4.0f, 300 }, ORANGE);
+}
+
+// --- WATER ---
+
+// Splashes all over the screen, then one frame of drying
+static void RunWater(void* ctx) {
+    SetRandomSeed(99);
+    for (int i = 0; i < SPLASH_OPS; i++) SpawnWaterSpread((Vector2){ (float)GetRandomValue(0, SCREEN_WIDTH), (float)GetRandomValue(0, SCREEN_HEIGHT) });
+    UpdateFluid(1.0f / 60.0f);
+}
+
+// --- FUSION ---
+
+// Core at the player's feet with every blob inside FUSION_RADIUS of it
+static void SetupFusion(void* ctx) {
+    BuildScene(*(int*)ctx);
+    for (int i = 1; i < store.count; i++) {
+        float angle = i * 2.39996f;
+        float dist = (float)(i % 100) * (FUSION_RADIUS / 100.0f);
+        ENTITY(&store, i)->position = (Vector2){ 400 + cosf(angle) * dist, 300 + sinf(angle) * dist };
+    }
+    BuildSpatialIndex(&store);
+}
+
+static void RunFusion(void* ctx) {
+    PerformSpatialFusion(&store, 1, &particles, &playerData);
+}
+
+// --- STEERING ---
+
+// Every blob turned into a swarm spell, moving in a random direction
+static void SetupSteering(void* ctx) {
+    BuildScene(*(int*)ctx);
+    for (int i = 1; i < store.count; i++) {
+        Entity* e = ENTITY(&store, i);
+        e->state = STATE_PROJECTILE; e->isSpell = true; e->ai = AI_SWARM; e->maxSpeed = 600.0f;
+        e->velocity = (Vector2){ (float)GetRandomValue(-200, 200), (float)GetRandomValue(-200, 200) };
+    }
+    BuildSpatialIndex(&store);
+}
+
+static void RunSteering(void* ctx) {
+    UpdateSteering(&store, ENTITY(&store, 0)->position, (Vector2){ 0 }, 1.0f / 60.0f);
+}
+
+// --- SPAWN / DESPAWN ---
+
+static void SetupChurn(void* ctx) { BuildScene(*(int*)ctx); }
+
+// Frees every other slot, then fills them again from the free list
+static void RunChurn(void* ctx) {
+    int n = *(int*)ctx;
+    EntityData blob = CreateRawElement(ELEM_EARTH, (Vector2){ 400, 300 });
+    for (int i = 1; i < n; i += 2) DespawnEntity(&store, i);
+    for (int i = 1; i < n; i += 2) SpawnEntity(&store, blob);
+}
+
+int main(int argc, char** argv) {
+    SetTraceLogLevel(LOG_WARNING);
+    SetRandomSeed(42);
+    InitGrass(&grass);
+
+    int sizes[] = { 100, 500, 2000 };
+    for (int i = 0; i < 3; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "ResolveEntityCollisions/n%d", sizes[i]);
+        BenchRun(name, SetupCollisions, RunCollisions, &sizes[i], 1);
+    }
+    for (int i = 0; i < 3; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "BuildSpatialIndex/n%d", sizes[i]);
+        BenchRun(name, SetupIndex, RunIndex, &sizes[i], 1);
+    }
+    for (int i = 0; i < 3; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "UpdateGrass/n%d", sizes[i]);
+        BenchRun(name, SetupGrass, RunGrass, &sizes[i], GRASS_OPS);
+    }
+
+    BenchRun("UpdateParticles/full", SetupParticles, RunParticles, NULL, PARTICLE_OPS);
+    BenchRun("SpawnExplosion/x200", SetupExplosions, RunExplosions, NULL, EXPLOSION_OPS);
+
+    BenchRun("SpawnWaterSpread/x100", NULL, RunWater, NULL, SPLASH_OPS);
+
+    int fused = 64;
+    BenchRun("PerformSpatialFusion/n64", SetupFusion, RunFusion, &fused, 1);
+
+    int swarms[] = { 500, 4000 };
+    for (int i = 0; i < 2; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "UpdateSteering/swarm%d", swarms[i]);
+        BenchRun(name, SetupSteering, RunSteering, &swarms[i], 1);
+    }
+    ShutdownSteering();
+
+    int churn = CHURN_ENTITIES;
+    BenchRun("SpawnDespawn/n100000", SetupChurn, RunChurn, &churn, CHURN_ENTITIES);
+
+    return BenchFinish(argc, argv, "legacy");
+}
@@ -0,0 +1,84 @@
+#include "game.h"
+
+// --- ENTITY STORE ---
+// Hot and cold halves of every entity (see Entity in game.h), in pages of
+// ENTITY_PAGE_SIZE slots. A page is allocated when the last one fills up and
+// then never moves or goes away until FreeEntityStore. So an entity's index
+// and any pointer into a page stay valid for its whole life, even while other
+// code spawns more.
+//
+// Despawning frees the slot in place: it goes on a free list (LIFO, so the
+// next spawn reuses memory that is still warm) and its generation is bumped,
+// which makes old handles to it resolve to -1. Nothing is ever moved, so
+// there is no compaction. Loops run over 0..count and skip !isActive slots.
+//
+// Sweeps over all entities (physics, collisions, the spatial index, grass)
+// only read the hot arrays, about a quarter of the bytes of the old struct.
+
+void InitEntityStore(EntityStore* store) {
+    *store = (EntityStore){ .freeHead = -1 };
+}
+
+void FreeEntityStore(EntityStore* store) {
+    for (int p = 0; p < store->pageCount; p++) TagFree(store->pages[p]);
+    *store = (EntityStore){ .freeHead = -1 };
+}
+
+// The hot copies of the spell's kind, read by physics without touching the spell
+void SyncEntityKind(Entity* e, const Spell* s) {
+    e->element = (unsigned char)s->core;
+    e->behavior = (unsigned char)s->behavior;
+    e->ai = (unsigned char)s->aiType;
+}
+
+// O(1): a freed slot if there is one, else the next new slot (adding a page when needed)
+EntityHandle SpawnEntity(EntityStore* store, EntityData data) {
+    int i = store->freeHead;
+    if (i >= 0) {
+        store->freeHead = store->pages[i >> ENTITY_PAGE_SHIFT]->nextFree[i & (ENTITY_PAGE_SIZE - 1)];
+    } else {
+        if (store->count == store->pageCount * ENTITY_PAGE_SIZE) {
+            if (store->pageCount == ENTITY_MAX_PAGES) return (EntityHandle){ -1, 0 };
+            EntityPage* page = TagCalloc(MEM_ENTITIES, 1, sizeof(EntityPage));
+            if (!page) return (EntityHandle){ -1, 0 };
+            store->pages[store->pageCount++] = page;
+        }
+        i = store->count++;
+    }
+    EntityPage* page = store->pages[i >> ENTITY_PAGE_SHIFT];
+    int slot = i & (ENTITY_PAGE_SIZE - 1);
+    page->hot[slot] = data.hot;
+    page->cold[slot] = data.cold;
+    page->live[slot] = true;
+    SyncEntityKind(&page->hot[slot], &page->cold[slot].spellData);
+    store->alive++;
+    return (EntityHandle){ i, page->generation[slot] };
+}
+
+// O(1). The slot reads as inactive until it is reused.
+void DespawnEntity(EntityStore* store, int index) {
+    EntityPage* page = store->pages[index >> ENTITY_PAGE_SHIFT];
+    int slot = index & (ENTITY_PAGE_SIZE - 1);
+    if (!page->live[slot]) return;
+    page->live[slot] = false;
+    page->hot[slot].isActive = false;
+    page->generation[slot]++;
+    page->nextFree[slot] = store->freeHead;
+    store->freeHead = index;
+    store->alive--;
+}
+
+EntityData GetEntityData(EntityStore* store, int index) {
+    return (EntityData){ *ENTITY(store, index), *ENTITY_INFO(store, index) };
+}
+
+EntityHandle GetEntityHandle(EntityStore* store, int index) {
+    return (EntityHandle){ index, store->pages[index >> ENTITY_PAGE_SHIFT]->generation[index & (ENTITY_PAGE_SIZE - 1)] };
+}
+
+int ResolveEntity(EntityStore* store, EntityHandle h) {
+    if (h.index < 0 || h.index >= store->count) return -1;
+    EntityPage* page = store->pages[h.index >> ENTITY_PAGE_SHIFT];
+    int slot = h.index & (ENTITY_PAGE_SIZE - 1);
+    return (page->live[slot] && page->generation[slot] == h.generation) ? h.index : -1;
+}
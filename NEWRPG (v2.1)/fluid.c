@@ -0,0 +1,109 @@
+#include "game.h"
+
+// --- FLUID GRID ---
+// Standing water lives in a grid of FLUID_CELL squares over the screen, not
+// in entities. A splash or a settled water blob deposits depth into the cells
+// it covers, and every cell dries at the same rate. Coverage (depth capped at
+// 1) is what walkers feel and what is drawn, so a fresh puddle stays full
+// until its depth drops below 1 and then fades out.
+//
+// Walkers read one cell per frame for drag, however much water is down.
+// Drawing uploads the coverage as a small texture, one texel per cell, and
+// stretches it over the screen with bilinear filtering: one quad for all
+// the water. The grid is fixed, so puddles cost nothing from the entity budget.
+
+#define FLUID_CELL 8
+#define FLUID_W (SCREEN_WIDTH / FLUID_CELL)
+#define FLUID_H (SCREEN_HEIGHT / FLUID_CELL)
+#define FLUID_DRY_RATE 0.1f     // Depth lost per second: FLUID_DEPOSIT is 20 s full, then 10 s fading
+#define FLUID_MAX_DEPTH 6.0f
+#define FLUID_SPLASH_DROPS 12
+#define FLUID_SPLASH_TIME 0.25f // How far a drop flies: its speed times this
+#define FLUID_DROP_RADIUS 6.0f
+
+static float depth[FLUID_W * FLUID_H];
+static Color texels[FLUID_W * FLUID_H];
+static Texture2D texture;
+static bool textureLoaded = false;
+static bool textureWet = false; // Texture still shows water
+static int wetCells = 0;
+
+// Needs the window (it creates the texture)
+void InitFluid() {
+    TrackStatic(MEM_RENDER, "fluid grid", sizeof(depth) + sizeof(texels));
+    memset(depth, 0, sizeof(depth));
+    wetCells = 0;
+    Image img = GenImageColor(FLUID_W, FLUID_H, BLANK);
+    texture = LoadTextureFromImage(img);
+    UnloadImage(img);
+    SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+    textureLoaded = true;
+}
+
+void UnloadFluid() {
+    if (textureLoaded) UnloadTexture(texture);
+    textureLoaded = false;
+}
+
+// Adds amount of depth to every cell whose center is within radius of center
+void DepositWater(Vector2 center, float radius, float amount) {
+    int x0 = (int)fmaxf((center.x - radius) / FLUID_CELL, 0), x1 = (int)fminf((center.x + radius) / FLUID_CELL, FLUID_W - 1);
+    int y0 = (int)fmaxf((center.y - radius) / FLUID_CELL, 0), y1 = (int)fminf((center.y + radius) / FLUID_CELL, FLUID_H - 1);
+    bool any = false;
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            float dx = (x + 0.5f) * FLUID_CELL - center.x, dy = (y + 0.5f) * FLUID_CELL - center.y;
+            if (dx * dx + dy * dy > radius * radius) continue;
+            float* d = &depth[y * FLUID_W + x];
+            *d = fminf(*d + amount, FLUID_MAX_DEPTH);
+            any = true;
+        }
+    }
+    // Smaller than a cell: still wet the one it landed in
+    if (!any) {
+        int x = (int)(center.x / FLUID_CELL), y = (int)(center.y / FLUID_CELL);
+        if (x >= 0 && x < FLUID_W && y >= 0 && y < FLUID_H) depth[y * FLUID_W + x] = fminf(depth[y * FLUID_W + x] + amount, FLUID_MAX_DEPTH);
+    }
+}
+
+// A burst of drops landing around origin, where the old droplet entities came to rest
+void SpawnWaterSpread(Vector2 origin) {
+    for (int i = 0; i < FLUID_SPLASH_DROPS; i++) {
+        float angle = (float)GetRandomValue(0, 360) * DEG2RAD;
+        float speed = (float)GetRandomValue(50, 150);
+        Vector2 land = { origin.x + cosf(angle) * speed * FLUID_SPLASH_TIME, origin.y + sinf(angle) * speed * FLUID_SPLASH_TIME };
+        DepositWater(land, FLUID_DROP_RADIUS, FLUID_DEPOSIT);
+    }
+}
+
+// 0 (dry) to 1 (fully covered) at p. O(1).
+float GetWaterCoverage(Vector2 p) {
+    int x = (int)(p.x / FLUID_CELL), y = (int)(p.y / FLUID_CELL);
+    if (p.x < 0 || p.y < 0 || x >= FLUID_W || y >= FLUID_H) return 0.0f;
+    return fminf(depth[y * FLUID_W + x], 1.0f);
+}
+
+void UpdateFluid(float dt) {
+    int wet = 0;
+    for (int i = 0; i < FLUID_W * FLUID_H; i++) {
+        if (depth[i] <= 0) continue;
+        depth[i] -= FLUID_DRY_RATE * dt;
+        if (depth[i] < 0) depth[i] = 0;
+        else wet++;
+    }
+    wetCells = wet;
+}
+
+int GetWetCellCount() { return wetCells; }
+
+// All standing water in one textured quad (called by DrawGame, under the walls)
+void DrawFluid() {
+    if (!textureLoaded || (wetCells == 0 && !textureWet)) return;
+    textureWet = wetCells > 0;
+    for (int i = 0; i < FLUID_W * FLUID_H; i++) {
+        float c = fminf(depth[i], 1.0f);
+        texels[i] = (Color){ BLUE.r, BLUE.g, BLUE.b, (unsigned char)(c * 0.4f * 255) };
+    }
+    UpdateTexture(texture, texels);
+    DrawTexturePro(texture, (Rectangle){ 0, 0, FLUID_W, FLUID_H }, (Rectangle){ 0, 0, FLUID_W * FLUID_CELL, FLUID_H * FLUID_CELL }, (Vector2){ 0, 0 }, 0.0f, WHITE);
+}
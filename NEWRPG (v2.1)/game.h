@@ -13,17 +13,17 @@
 #define SCREEN_HEIGHT 600
 #define WALL_COUNT 3
 #define INVENTORY_CAPACITY 5
-#define MAX_PARTICLES 1000 
+#define MAX_PARTICLES 100000 // A multiple of 4 (see particles.c)
 #define MAX_GRASS 4000 
 #define MAX_AUX 8 
 #define FUSION_RADIUS 150.0f 
 
 // --- OPTIMIZATION & FLUID CONSTANTS ---
-#define MAX_ENTITIES 2000 
-#define GRID_CELL_SIZE 80
-#define GRID_COLS (SCREEN_WIDTH / GRID_CELL_SIZE + 1)
-#define GRID_ROWS (SCREEN_HEIGHT / GRID_CELL_SIZE + 1)
-#define MAX_ENTITIES_PER_CELL 64 
+#define ENTITY_PAGE_SHIFT 10
+#define ENTITY_PAGE_SIZE (1 << ENTITY_PAGE_SHIFT) // Slots per page
+#define ENTITY_MAX_PAGES 256
+#define MAX_ENTITIES (ENTITY_PAGE_SIZE * ENTITY_MAX_PAGES) // 262144; pages are added as needed
+#define FLUID_DEPOSIT 3.0f // Water depth a splash or a settled blob leaves
 
 #ifndef PI
 #define PI 3.14159265358979323846f
@@ -38,8 +38,7 @@ typedef enum { ELEM_NONE = 0, ELEM_EARTH, ELEM_WATER, ELEM_FIRE, ELEM_AIR } Elem
 typedef enum { 
     STATE_RAW, 
     STATE_PROJECTILE, 
-    STATE_STATIC_WALL, 
-    STATE_POOL // Floor water
+    STATE_STATIC_WALL // Floor water is not an entity (see fluid.c)
 } EntityState;
 
 // --- SPELL LIST ---
@@ -62,13 +61,46 @@ typedef struct {
     bool isTeleport; bool hasHoming; bool hasGravity;
 } Spell;
 
+// --- ENTITIES (see entities.c) ---
+// Split by how often they are read. Entity is the hot part: what physics,
+// collisions, AI and picking touch every frame, packed into ~50 bytes.
+// EntityInfo is the cold part, read by drawing, the UI and fusion. Both live
+// in the pages of an EntityStore, at the same slot index. A slot keeps its
+// index for the entity's whole life; an EntityHandle also remembers which
+// life, so it notices when the slot has been reused.
 typedef struct {
     Vector2 position; Vector2 velocity; float mass; float friction; float size;
-    float maxSpeed; float moveForce; Color color; float health; float maxHealth;
-    EntityState state; Spell spellData; bool isActive; bool isSpell; bool isHeld;
-    float lifeTime; Vector2 targetPos; int targetID;         
+    float maxSpeed; float moveForce; float lifeTime; EntityState state;
+    unsigned char element, behavior, ai; // Copies of spellData.core/behavior/aiType (SyncEntityKind)
+    bool isActive; bool isSpell; bool isHeld;
 } Entity;
 
+typedef struct { int index; unsigned int generation; } EntityHandle; // index -1 = none
+
+typedef struct {
+    Spell spellData; Color color; float health; float maxHealth;
+    Vector2 targetPos; EntityHandle target;
+} EntityInfo;
+
+typedef struct { Entity hot; EntityInfo cold; } EntityData; // A whole entity outside the store (spawning, inventory)
+
+typedef struct {
+    Entity hot[ENTITY_PAGE_SIZE]; EntityInfo cold[ENTITY_PAGE_SIZE];
+    unsigned int generation[ENTITY_PAGE_SIZE]; // Bumped when the slot is freed
+    int nextFree[ENTITY_PAGE_SIZE];            // Free list link
+    bool live[ENTITY_PAGE_SIZE];
+} EntityPage;
+
+typedef struct {
+    EntityPage* pages[ENTITY_MAX_PAGES]; int pageCount; // Pages never move once allocated
+    int count;    // Slots handed out so far: loop to here and skip !isActive
+    int alive;    // Live entities
+    int freeHead; // Most recently freed slot, -1 = none
+} EntityStore;
+
+#define ENTITY(store, i) (&(store)->pages[(i) >> ENTITY_PAGE_SHIFT]->hot[(i) & (ENTITY_PAGE_SIZE - 1)])
+#define ENTITY_INFO(store, i) (&(store)->pages[(i) >> ENTITY_PAGE_SHIFT]->cold[(i) & (ENTITY_PAGE_SIZE - 1)])
+
 typedef struct {
     bool discovered[SPELL_COUNT]; float notificationTimer; char notificationText[64]; float scrollY; 
 } Compendium;
@@ -77,49 +109,143 @@ typedef struct {
     ElementType selectedElement; float mana; float maxMana; Compendium book; 
 } Player;
 
-typedef struct { Entity items[INVENTORY_CAPACITY]; int count; int selectedSlot; } Inventory;
-typedef struct { Vector2 position; Vector2 velocity; Color color; float life; float size; bool active; } Particle;
-typedef struct { Particle particles[MAX_PARTICLES]; } ParticleSystem;
+typedef struct { EntityData items[INVENTORY_CAPACITY]; int count; int selectedSlot; } Inventory;
+typedef struct {
+    float x[MAX_PARTICLES], y[MAX_PARTICLES], vx[MAX_PARTICLES], vy[MAX_PARTICLES]; // Velocity in pixels per second
+    float life[MAX_PARTICLES], size[MAX_PARTICLES]; Color color[MAX_PARTICLES];
+    int count; // Live particles: slots 0 .. count - 1
+} ParticleSystem;
 
 // --- GRASS ---
+// One array per field, blades sorted by tile (see graphics.c), so quiet tiles
+// update a run of blades four at a time
+typedef struct {
+    float x[MAX_GRASS], y[MAX_GRASS];
+    float angle[MAX_GRASS], stiffness[MAX_GRASS], height[MAX_GRASS];
+    float phase[MAX_GRASS]; // Wind phase from the position, in [0, 2 PI)
+    Color color[MAX_GRASS];
+} GrassSystem;
+
+// --- SIMD ---
+// Four floats in one register: GCC/Clang vector extensions, so SSE on x86
+// and NEON on ARM. Loads and stores need no alignment.
+typedef float Float4 __attribute__((vector_size(16)));
+typedef int Int4 __attribute__((vector_size(16)));
+static inline Float4 LoadFloat4(const float* p) { Float4 v; memcpy(&v, p, sizeof(v)); return v; }
+static inline void StoreFloat4(float* p, Float4 v) { memcpy(p, &v, sizeof(v)); }
+static inline Float4 SplatFloat4(float f) { return (Float4){ f, f, f, f }; }
+
+// --- MEMORY ACCOUNTING (see memory.c) ---
+typedef enum { MEM_WORLD = 0, MEM_RENDER, MEM_ENTITIES, MEM_PARTICLES, MEM_UI, MEM_TAG_COUNT } MemTag;
+typedef struct {
+    long long live, peak;         // Heap bytes held now / at most
+    size_t staticBytes;           // Fixed arrays (TrackStatic)
+    long long allocs, allocated;  // Ever made, in count and bytes
+    int frameAllocs; size_t frameBytes; // During the last frame
+    float bytesPerSecond;
+} MemoryStats;
+extern const char* MemTagNames[MEM_TAG_COUNT];
+
+// --- COLLISION COUNTERS (last ResolveEntityCollisions call) ---
 typedef struct {
-    Vector2 position; float angle; float targetAngle; float stiffness; float height; Color color;
-} Grass;
-typedef struct { Grass blades[MAX_GRASS]; } GrassSystem;
+    int entities;        // Active entities swept
+    long long allPairs;  // What testing every i<j pair would cost
+    int pairsTested;     // Candidates the broadphase handed to the narrowphase
+    int overlaps;        // Candidates that really touched
+} CollisionStats;
 
 // --- PROTOTYPES ---
 void InitParticles(ParticleSystem* ps);
-void UpdateParticles(ParticleSystem* ps);
+void UpdateParticles(ParticleSystem* ps, float dt);
 void DrawParticles(ParticleSystem* ps); 
 void SpawnExplosion(ParticleSystem* ps, Vector2 position, Color color);
 
 void InitGrass(GrassSystem* gs);
-void UpdateGrass(GrassSystem* gs, Entity* entities, int count);
-void DrawGrass(GrassSystem* gs);
+void UpdateGrass(GrassSystem* gs, EntityStore* store);
+void DrawGrass(GrassSystem* gs, Camera2D camera); // Inside BeginMode2D
+void UnloadGrassMesh();
 
 void InitInventory(Inventory* inv);
-bool AddItem(Inventory* inv, Entity item);
-Entity DropItem(Inventory* inv, int index);
+bool AddItem(Inventory* inv, EntityData item);
+EntityData DropItem(Inventory* inv, int index);
 void DrawInventory(Inventory* inv, int x, int y);
 
 Color GetElementColor(ElementType type);
-Entity CreateRawElement(ElementType type, Vector2 pos);
-void PerformSpatialFusion(Entity* entities, int count, int coreIndex, ParticleSystem* ps, Player* player);
+EntityData CreateRawElement(ElementType type, Vector2 pos);
+void PerformSpatialFusion(EntityStore* store, int coreIndex, ParticleSystem* ps, Player* player);
 Spell FuseSpellData(Spell A, Spell B); 
+void RecalculateStats(Spell* s); // Behavior and AI from the fusion table (see magic.c)
+bool GetFusionRecipe(SpellBehavior behavior, ElementType* core, int count[5]);
 
 int GetSpellChunkCount(Entity* e);
 Vector2 GetSpellChunkPos(Entity* e, int index, float time);
 float GetSpellChunkSize(Entity* e, int index);
 
-void UpdateEntityPhysics(Entity* e, Vector2 inputDirection, Rectangle* walls, int wallCount);
-void UpdateEntityAI(Entity* e, Entity* entities, int count, Vector2 targetPos); 
-void ResolveEntityCollisions(Entity* entities, int* count, Entity* player, ParticleSystem* ps); 
-void ApplySpellFieldEffects(Entity* entities, int count, ParticleSystem* ps); 
+void InitEntityStore(EntityStore* store);
+void FreeEntityStore(EntityStore* store);
+EntityHandle SpawnEntity(EntityStore* store, EntityData data); // .index is -1 when full
+void DespawnEntity(EntityStore* store, int index);             // Frees the slot, nothing moves
+EntityData GetEntityData(EntityStore* store, int index);
+EntityHandle GetEntityHandle(EntityStore* store, int index);
+int ResolveEntity(EntityStore* store, EntityHandle h);         // Index, or -1 once that entity is gone
+void SyncEntityKind(Entity* e, const Spell* s);
 
-void DrawGame(Entity* entities, int count, Rectangle* walls, int wallCount);
+void UpdateEntityPhysics(Entity* e, Vector2 inputDirection, Rectangle* walls, int wallCount);
+void ResolveEntityCollisions(EntityStore* store, ParticleSystem* ps); 
+void ApplySpellFieldEffects(EntityStore* store, ParticleSystem* ps); 
+const CollisionStats* GetCollisionStats();
+
+// Spatial index: rebuilt once per frame, results in index order (see spatial.c).
+// Results are in a buffer of the index, valid until the next query.
+void BuildSpatialIndex(EntityStore* store);
+int QueryPoint(Vector2 p, const int** out);
+int QueryRadius(Vector2 center, float radius, const int** out);
+int QueryRect(Rectangle r, const int** out);
+int QueryNearest(Vector2 p, int k, const int** out);
+typedef bool (*GatherFilter)(int index, const void* ctx);
+int GatherRadius(Vector2 center, float radius, GatherFilter keep, const void* ctx, int* out, int max); // Thread-safe, unsorted, caller's buffer
+
+// Steering: every AI spell's velocity for the frame, computed in parallel
+// chunks from last frame's state (see steering.c)
+void UpdateSteering(EntityStore* store, Vector2 targetPos, Vector2 targetVelocity, float dt);
+void ShutdownSteering();
+
+// Fluid grid: standing water as depth per cell instead of entities (see fluid.c)
+void InitFluid(); // After InitWindow
+void UnloadFluid();
+void DepositWater(Vector2 center, float radius, float amount);
+void SpawnWaterSpread(Vector2 origin);
+float GetWaterCoverage(Vector2 p); // 0 = dry, 1 = covered
+void UpdateFluid(float dt);
+void DrawFluid();
+int GetWetCellCount();
+
+// Sprite atlas: spell visuals as textured quads from one texture (see sprites.c)
+typedef enum {
+    SPRITE_SQUARE, SPRITE_SQUARE_LINES, SPRITE_DISC, SPRITE_RING, SPRITE_HALF_RING,
+    SPRITE_TRIANGLE, SPRITE_HEXAGON, SPRITE_WEDGE, SPRITE_COUNT
+} SpriteShape;
+void InitSpriteAtlas(); // After InitWindow
+void UnloadSpriteAtlas();
+void PushSprite(SpriteShape shape, Vector2 center, float halfW, float halfH, float rotation, Color tint);
+void PushLine(Vector2 a, Vector2 b, float thick, Color tint);
+void FlushSprites(); // Inside BeginMode2D
+int GetSpriteCount(); // Quads in the last flush
+
+void DrawGame(EntityStore* store, Rectangle* walls, int wallCount);
 void DrawElementWheel(Player* player, Vector2 mousePos);
-void DrawEntityTooltip(Entity* e, int x, int y);
-void DrawHUD(Entity* player, Player* stats); 
+void DrawEntityTooltip(Entity* e, EntityInfo* info, int x, int y);
+void DrawHUD(EntityInfo* player, Player* stats); 
 void DrawCompendium(Player* player); 
+void DrawMemoryPanel(); // [F3]
+
+void* TagCalloc(MemTag tag, size_t count, size_t size);
+void* TagRealloc(MemTag tag, void* p, size_t size);
+void* TagGrow(MemTag tag, void* p, size_t size, bool* ok);
+void TagFree(void* p);
+void TrackStatic(MemTag tag, const char* name, size_t bytes);
+void MemoryEndFrame();
+const MemoryStats* GetMemoryStats(MemTag tag);
+void PrintMemoryReport(FILE* f);
 
 #endif
\ No newline at end of file
@@ -1,120 +1,311 @@
 #include "game.h"
+#include "rlgl.h"
 #include <math.h>
 
-// --- OPTIMIZATION GLOBALS ---
-#define GRID_CELL_SIZE 80
-#define GRID_COLS (SCREEN_WIDTH / GRID_CELL_SIZE + 1)
-#define GRID_ROWS (SCREEN_HEIGHT / GRID_CELL_SIZE + 1)
-#define MAX_ENTITIES_PER_CELL 64 
+// --- GRASS SYSTEM ---
+// Blades never move, so InitGrass sorts them into tiles once and stores them
+// in tile order. Each frame every entity lists itself in the tiles within its
+// reach (a counting sort, like the spatial index). A tile nobody reaches only
+// sways in the wind: its blades are a contiguous run, updated four at a time
+// with a polynomial sine. Only tiles with an entity in reach run the
+// per-blade push test. So the cost follows the grass that is being walked
+// through, not the grass on screen.
 
-static int cellCounts[GRID_ROWS][GRID_COLS];
-static int cellContents[GRID_ROWS][GRID_COLS][MAX_ENTITIES_PER_CELL];
+#define GRASS_TILE 32
+#define GRASS_TILE_COLS (SCREEN_WIDTH / GRASS_TILE + 1)
+#define GRASS_TILE_ROWS (SCREEN_HEIGHT / GRASS_TILE + 1)
+#define GRASS_TILES (GRASS_TILE_COLS * GRASS_TILE_ROWS)
+#define GRASS_WIND_SPEED 1.5f
+#define GRASS_WIND 0.2f
 
-// --- GRASS SYSTEM ---
+static int tileStart[GRASS_TILES + 1];   // Blades of tile t: tileStart[t] .. tileStart[t + 1]
+static int pusherStart[GRASS_TILES + 1]; // Entities near tile t: pushers[pusherStart[t] .. pusherStart[t + 1]]
+static int pusherFill[GRASS_TILES];
+static int* pushers = NULL;
+static int pusherCapacity = 0;
 
 void InitGrass(GrassSystem* gs) {
+    TrackStatic(MEM_WORLD, "grass tiles", sizeof(tileStart) + sizeof(pusherStart) + sizeof(pusherFill));
+    int* tileOf = TagCalloc(MEM_WORLD, MAX_GRASS, sizeof(int));
+    GrassSystem* spawned = TagCalloc(MEM_WORLD, 1, sizeof(GrassSystem)); // In spawn order, before sorting
     for(int i=0; i<MAX_GRASS; i++) {
-        gs->blades[i].position = (Vector2){ (float)GetRandomValue(0, SCREEN_WIDTH), (float)GetRandomValue(0, SCREEN_HEIGHT) };
-        gs->blades[i].angle = 0.0f;
-        gs->blades[i].targetAngle = 0.0f;
-        gs->blades[i].stiffness = (float)GetRandomValue(3, 6) * 0.01f; 
-        gs->blades[i].height = (float)GetRandomValue(8, 15);
+        spawned->x[i] = (float)GetRandomValue(0, SCREEN_WIDTH);
+        spawned->y[i] = (float)GetRandomValue(0, SCREEN_HEIGHT);
+        spawned->stiffness[i] = (float)GetRandomValue(3, 6) * 0.01f; 
+        spawned->height[i] = (float)GetRandomValue(8, 15);
         int g = GetRandomValue(120, 180);
-        gs->blades[i].color = (Color){ 20, g, 20, 255 }; 
+        spawned->color[i] = (Color){ 20, g, 20, 255 }; 
+    }
+
+    int fill[GRASS_TILES];
+    memset(tileStart, 0, sizeof(tileStart));
+    for(int i=0; i<MAX_GRASS; i++) {
+        tileOf[i] = (int)(spawned->y[i] / GRASS_TILE) * GRASS_TILE_COLS + (int)(spawned->x[i] / GRASS_TILE);
+        tileStart[tileOf[i] + 1]++;
     }
+    for(int t=0; t<GRASS_TILES; t++) { tileStart[t + 1] += tileStart[t]; fill[t] = tileStart[t]; }
+    for(int i=0; i<MAX_GRASS; i++) {
+        int b = fill[tileOf[i]]++;
+        gs->x[b] = spawned->x[i]; gs->y[b] = spawned->y[i];
+        gs->angle[b] = 0.0f;
+        gs->stiffness[b] = spawned->stiffness[i]; gs->height[b] = spawned->height[i]; gs->color[b] = spawned->color[i];
+        gs->phase[b] = fmodf((spawned->x[i] + spawned->y[i]) * 0.02f, 2 * PI);
+    }
+    TagFree(spawned); TagFree(tileOf);
 }
 
-void UpdateGrass(GrassSystem* gs, Entity* entities, int count) {
-    float time = GetTime();
+// sin(a) for a in [0, 4 PI), to within 0.001: a parabola plus one correction
+// step. The same sums as WindSin4, so both tiers agree.
+static float WindSin(float a) {
+    a -= 2 * PI * (float)(int)((a + PI) * (1.0f / (2 * PI)));
+    float y = (4 / PI) * a - (4 / (PI * PI)) * a * fabsf(a);
+    return 0.225f * (y * fabsf(y) - y) + y;
+}
 
-    // 1. POPULATE GRID
-    for(int y=0; y<GRID_ROWS; y++) { for(int x=0; x<GRID_COLS; x++) cellCounts[y][x] = 0; }
-
-    for(int i=0; i<count; i++) {
-        if(!entities[i].isActive) continue;
-        int minX = (int)((entities[i].position.x - entities[i].size - 30) / GRID_CELL_SIZE);
-        int maxX = (int)((entities[i].position.x + entities[i].size + 30) / GRID_CELL_SIZE);
-        int minY = (int)((entities[i].position.y - entities[i].size - 30) / GRID_CELL_SIZE);
-        int maxY = (int)((entities[i].position.y + entities[i].size + 30) / GRID_CELL_SIZE);
-        if (minX < 0) minX = 0; if (maxX >= GRID_COLS) maxX = GRID_COLS - 1;
-        if (minY < 0) minY = 0; if (maxY >= GRID_ROWS) maxY = GRID_ROWS - 1;
-        for (int y = minY; y <= maxY; y++) {
-            for (int x = minX; x <= maxX; x++) {
-                if (cellCounts[y][x] < MAX_ENTITIES_PER_CELL) {
-                    cellContents[y][x][cellCounts[y][x]++] = i;
+static Float4 Abs4(Float4 v) { return (Float4)((Int4)v & 0x7fffffff); }
+
+static Float4 WindSin4(Float4 a) {
+    a -= 2 * PI * __builtin_convertvector(__builtin_convertvector((a + PI) * (1.0f / (2 * PI)), Int4), Float4);
+    Float4 y = (4 / PI) * a - (4 / (PI * PI)) * a * Abs4(a);
+    return 0.225f * (y * Abs4(y) - y) + y;
+}
+
+// Blades first .. last with nothing near: ease towards the wind
+static void SwayBlades(GrassSystem* gs, int first, int last, float windTime) {
+    int b = first;
+    for(; b + 4 <= last; b += 4) {
+        Float4 wind = WindSin4(SplatFloat4(windTime) + LoadFloat4(&gs->phase[b])) * GRASS_WIND;
+        Float4 angle = LoadFloat4(&gs->angle[b]);
+        StoreFloat4(&gs->angle[b], angle + (wind - angle) * LoadFloat4(&gs->stiffness[b]));
+    }
+    for(; b < last; b++) {
+        float wind = WindSin(windTime + gs->phase[b]) * GRASS_WIND;
+        gs->angle[b] += (wind - gs->angle[b]) * gs->stiffness[b];
+    }
+}
+
+// Lists, per tile, the active entities whose reach (size + 20) touches it, in index order
+static void FindPushers(EntityStore* store) {
+    memset(pusherStart, 0, sizeof(pusherStart));
+    int total = 0;
+    for(int pass=0; pass<2; pass++) {
+        if (pass == 1) {
+            for(int t=0; t<GRASS_TILES; t++) { pusherStart[t + 1] += pusherStart[t]; pusherFill[t] = pusherStart[t]; }
+            total = pusherStart[GRASS_TILES];
+            if (total > pusherCapacity) {
+                int capacity = pusherCapacity ? pusherCapacity : 1024;
+                while (capacity < total) capacity *= 2;
+                int* grown = TagRealloc(MEM_WORLD, pushers, capacity * sizeof(int));
+                if (!grown) { memset(pusherStart, 0, sizeof(pusherStart)); return; } // Out of memory: no pushing this frame
+                pushers = grown; pusherCapacity = capacity;
+            }
+        }
+        for(int i=0; i<store->count; i++) {
+            Entity* e = ENTITY(store, i);
+            if (!e->isActive) continue;
+            float reach = e->size + 20.0f;
+            int c0 = (int)floorf((e->position.x - reach) / GRASS_TILE), c1 = (int)floorf((e->position.x + reach) / GRASS_TILE);
+            int r0 = (int)floorf((e->position.y - reach) / GRASS_TILE), r1 = (int)floorf((e->position.y + reach) / GRASS_TILE);
+            if (c0 < 0) c0 = 0;
+            if (r0 < 0) r0 = 0;
+            if (c1 >= GRASS_TILE_COLS) c1 = GRASS_TILE_COLS - 1;
+            if (r1 >= GRASS_TILE_ROWS) r1 = GRASS_TILE_ROWS - 1;
+            for(int r=r0; r<=r1; r++) {
+                for(int c=c0; c<=c1; c++) {
+                    int t = r * GRASS_TILE_COLS + c;
+                    if (pass == 0) pusherStart[t + 1]++;
+                    else pushers[pusherFill[t]++] = i;
                 }
             }
         }
     }
+}
 
-    // 2. UPDATE BLADES
-    for(int i=0; i<MAX_GRASS; i++) {
-        Grass* g = &gs->blades[i];
-        float wind = sinf(time * 1.5f + g->position.x * 0.02f + g->position.y * 0.02f) * 0.2f;
-        float pushOffset = 0.0f;
-        bool isInteracting = false;
-        
-        int gx = (int)(g->position.x / GRID_CELL_SIZE);
-        int gy = (int)(g->position.y / GRID_CELL_SIZE);
+void UpdateGrass(GrassSystem* gs, EntityStore* store) {
+    float windTime = fmodf((float)GetTime() * GRASS_WIND_SPEED, 2 * PI);
+    FindPushers(store);
+    int quiet = 0; // Start of the current run of quiet blades
 
-        if (gx >= 0 && gx < GRID_COLS && gy >= 0 && gy < GRID_ROWS) {
-            int localCount = cellCounts[gy][gx];
+    for(int t=0; t<GRASS_TILES; t++) {
+        int localCount = pusherStart[t + 1] - pusherStart[t];
+        if (localCount == 0 || tileStart[t] == tileStart[t + 1]) continue;
+        const int* nearby = &pushers[pusherStart[t]];
+
+        SwayBlades(gs, quiet, tileStart[t], windTime);
+        quiet = tileStart[t + 1];
+        for(int b=tileStart[t]; b<tileStart[t + 1]; b++) {
+            float wind = WindSin(windTime + gs->phase[b]) * GRASS_WIND;
+            float pushOffset = 0.0f;
+            bool isInteracting = false;
+            
             for(int k=0; k<localCount; k++) {
-                int entityIdx = cellContents[gy][gx][k];
-                Entity* e = &entities[entityIdx];
+                Entity* e = ENTITY(store, nearby[k]);
                 float radius = e->size + 20.0f; 
-                float dist = Vector2Distance(g->position, e->position);
-                if(dist < radius) {
-                    float strength = (1.0f - (dist / radius));
-                    float dx = g->position.x - e->position.x;
+                float dx = gs->x[b] - e->position.x, dy = gs->y[b] - e->position.y;
+                if(dx * dx + dy * dy < radius * radius) {
+                    float strength = (1.0f - (sqrtf(dx * dx + dy * dy) / radius));
                     dx += e->velocity.x * 0.12f; 
                     float dir = (dx >= 0) ? 1.0f : -1.0f;
-                    if (fabsf(dx) < 2.0f) { dir = (i % 2 == 0) ? 1.0f : -1.0f; } 
+                    if (fabsf(dx) < 2.0f) { dir = (b % 2 == 0) ? 1.0f : -1.0f; } 
                     pushOffset += dir * strength * 2.0f;
                     isInteracting = true;
                 }
             }
+            float targetAngle = wind + pushOffset;
+            float lerpSpeed = isInteracting ? 0.3f : gs->stiffness[b]; 
+            gs->angle[b] += (targetAngle - gs->angle[b]) * lerpSpeed;
+            if(gs->angle[b] > 1.8f) gs->angle[b] = 1.8f;
+            if(gs->angle[b] < -1.8f) gs->angle[b] = -1.8f;
         }
-        g->targetAngle = wind + pushOffset;
-        float lerpSpeed = isInteracting ? 0.3f : g->stiffness; 
-        g->angle += (g->targetAngle - g->angle) * lerpSpeed;
-        if(g->angle > 1.8f) g->angle = 1.8f; if(g->angle < -1.8f) g->angle = -1.8f;
     }
+    SwayBlades(gs, quiet, MAX_GRASS, windTime);
 }
 
-void DrawGrass(GrassSystem* gs) {
-    for(int i=0; i<MAX_GRASS; i++) {
-        Grass* g = &gs->blades[i];
-        Vector2 start = g->position;
-        float height = g->height;
-        float tipX = start.x + sinf(g->angle) * height;
-        float tipY = start.y - cosf(g->angle) * height;
-        Vector2 tip = { tipX, tipY };
-        float baseWidth = 2.5f;
-        float baseCos = cosf(g->angle) * baseWidth;
-        float baseSin = sinf(g->angle) * baseWidth;
-        Vector2 baseLeft  = { start.x - baseCos, start.y - baseSin };
-        Vector2 baseRight = { start.x + baseCos, start.y + baseSin };
-        Color tipColor = g->color; tipColor.g = (unsigned char)(g->color.g + 40 > 255 ? 255 : g->color.g + 40);
-        Color baseColor = g->color; baseColor.g = (unsigned char)(g->color.g - 40 < 0 ? 0 : g->color.g - 40);
-        DrawTriangle(baseLeft, baseRight, tip, baseColor); 
-        DrawPixelV(start, (Color){0, 40, 0, 100}); 
+// --- GRASS MESH ---
+// Every blade is one triangle in a mesh that is uploaded once, in the
+// blades' tile order. Root, shape and colour never change. The only per-frame data
+// is the angle, one float per vertex, and the vertex shader bends the blade
+// by it. So drawing is a copy of angles plus one draw call per row of
+// visible tiles (a single call when the view spans the screen's width). Tiles
+// outside the camera are neither uploaded nor drawn. The mesh is made on the
+// first draw, since it needs the window's GL context.
+
+#define GRASS_MAX_HEIGHT 15.0f
+
+static const char* grassVS =
+    "#version 330\n"
+    "in vec2 vertexPosition;\n"   // Blade root
+    "in vec2 vertexTexCoord;\n"   // x: -1/1 base corners (2.5 out), 0 tip. y: height
+    "in vec4 vertexColor;\n"
+    "in float vertexTexCoord2;\n" // Angle
+    "uniform mat4 mvp;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    float a = vertexTexCoord2;\n"
+    "    vec2 p = vertexPosition + ((vertexTexCoord.x == 0.0) ? vec2(sin(a), -cos(a)) * vertexTexCoord.y\n"
+    "                                                         : vec2(cos(a), sin(a)) * vertexTexCoord.x * 2.5);\n"
+    "    fragColor = vertexColor;\n"
+    "    gl_Position = mvp * vec4(p, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* grassFS =
+    "#version 330\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main() { finalColor = fragColor; }\n";
+
+static struct {
+    bool loaded;
+    unsigned int shader, vao, rootVbo, shapeVbo, colorVbo, angleVbo;
+    int mvpLoc;
+    float* angles; // 3 per blade, in tile order
+} grassMesh;
+
+static void LoadGrassMesh(GrassSystem* gs) {
+    int n = MAX_GRASS * 3;
+    Vector2* roots = TagCalloc(MEM_RENDER, n, sizeof(Vector2));
+    Vector2* shapes = TagCalloc(MEM_RENDER, n, sizeof(Vector2));
+    Color* colors = TagCalloc(MEM_RENDER, n, sizeof(Color));
+    grassMesh.angles = TagCalloc(MEM_RENDER, n, sizeof(float));
+    for(int b=0; b<MAX_GRASS; b++) {
+        Color color = gs->color[b];
+        Color tipColor = color; tipColor.g = (unsigned char)(color.g + 40 > 255 ? 255 : color.g + 40);
+        Color baseColor = color; baseColor.g = (unsigned char)(color.g - 40 < 0 ? 0 : color.g - 40);
+        // Base left, base right, tip: the old DrawTriangle order, now shaded up to the tip colour
+        for(int v=0; v<3; v++) {
+            roots[b * 3 + v] = (Vector2){ gs->x[b], gs->y[b] };
+            shapes[b * 3 + v] = (Vector2){ (v == 0) ? -1.0f : (v == 1) ? 1.0f : 0.0f, gs->height[b] };
+            colors[b * 3 + v] = (v == 2) ? tipColor : baseColor;
+        }
     }
+
+    grassMesh.shader = rlLoadShaderCode(grassVS, grassFS);
+    grassMesh.mvpLoc = rlGetLocationUniform(grassMesh.shader, "mvp");
+    grassMesh.vao = rlLoadVertexArray();
+    rlEnableVertexArray(grassMesh.vao);
+    // One buffer per attribute, so every attribute starts at offset 0
+    grassMesh.rootVbo = rlLoadVertexBuffer(roots, n * sizeof(Vector2), false);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+    grassMesh.shapeVbo = rlLoadVertexBuffer(shapes, n * sizeof(Vector2), false);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD);
+    grassMesh.colorVbo = rlLoadVertexBuffer(colors, n * sizeof(Color), false);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, RL_UNSIGNED_BYTE, true, 0, 0);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR);
+    grassMesh.angleVbo = rlLoadVertexBuffer(grassMesh.angles, n * sizeof(float), true);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2, 1, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2);
+    rlDisableVertexArray();
+
+    TagFree(roots); TagFree(shapes); TagFree(colors);
+    grassMesh.loaded = true;
 }
 
-// --- MAIN GAME DRAWING ---
+void UnloadGrassMesh() {
+    if (!grassMesh.loaded) return;
+    rlUnloadVertexArray(grassMesh.vao);
+    rlUnloadVertexBuffer(grassMesh.rootVbo); rlUnloadVertexBuffer(grassMesh.shapeVbo);
+    rlUnloadVertexBuffer(grassMesh.colorVbo); rlUnloadVertexBuffer(grassMesh.angleVbo);
+    rlUnloadShaderProgram(grassMesh.shader);
+    TagFree(grassMesh.angles);
+    memset(&grassMesh, 0, sizeof(grassMesh));
+}
 
-void DrawGame(Entity* entities, int count, Rectangle* walls, int wallCount) {
-    float time = GetTime();
+// Inside BeginMode2D(camera)
+void DrawGrass(GrassSystem* gs, Camera2D camera) {
+    if (!grassMesh.loaded) LoadGrassMesh(gs);
 
-    // 1. Draw POOLS
-    for (int i = 0; i < count; i++) {
-        if (entities[i].isActive && entities[i].state == STATE_POOL) {
-            Entity* e = &entities[i];
-            DrawRectangle(e->position.x - e->size, e->position.y - e->size, e->size * 2, e->size * 2, Fade(BLUE, 0.4f));
-            DrawRectangleLines(e->position.x - e->size, e->position.y - e->size, e->size * 2, e->size * 2, Fade(SKYBLUE, 0.2f));
+    // Tiles under the view, grown by the longest blade
+    Vector2 v0 = GetScreenToWorld2D((Vector2){ 0, 0 }, camera);
+    Vector2 v1 = GetScreenToWorld2D((Vector2){ SCREEN_WIDTH, SCREEN_HEIGHT }, camera);
+    int c0 = (int)floorf((v0.x - GRASS_MAX_HEIGHT) / GRASS_TILE), c1 = (int)floorf((v1.x + GRASS_MAX_HEIGHT) / GRASS_TILE);
+    int r0 = (int)floorf((v0.y - GRASS_MAX_HEIGHT) / GRASS_TILE), r1 = (int)floorf((v1.y + GRASS_MAX_HEIGHT) / GRASS_TILE);
+    if (c0 < 0) c0 = 0;
+    if (c1 >= GRASS_TILE_COLS) c1 = GRASS_TILE_COLS - 1;
+    if (r0 < 0) r0 = 0;
+    if (r1 >= GRASS_TILE_ROWS) r1 = GRASS_TILE_ROWS - 1;
+    if (c0 > c1 || r0 > r1) return;
+
+    // Blade ranges [first, last) of the visible tiles, merged when a row runs on into the next
+    int first[GRASS_TILE_ROWS], last[GRASS_TILE_ROWS], ranges = 0;
+    for(int r=r0; r<=r1; r++) {
+        int a = tileStart[r * GRASS_TILE_COLS + c0], b = tileStart[r * GRASS_TILE_COLS + c1 + 1];
+        if (a == b) continue;
+        if (ranges > 0 && last[ranges - 1] == a) last[ranges - 1] = b;
+        else { first[ranges] = a; last[ranges] = b; ranges++; }
+    }
+
+    rlDrawRenderBatchActive(); // Whatever raylib has batched goes first
+    rlEnableShader(grassMesh.shader);
+    rlSetUniformMatrix(grassMesh.mvpLoc, MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+    rlDisableBackfaceCulling();
+    rlEnableVertexArray(grassMesh.vao);
+    for(int k=0; k<ranges; k++) {
+        for(int b=first[k]; b<last[k]; b++) {
+            float a = gs->angle[b];
+            grassMesh.angles[b * 3] = a; grassMesh.angles[b * 3 + 1] = a; grassMesh.angles[b * 3 + 2] = a;
         }
+        rlUpdateVertexBuffer(grassMesh.angleVbo, &grassMesh.angles[first[k] * 3], (last[k] - first[k]) * 3 * sizeof(float), first[k] * 3 * sizeof(float));
+        rlDrawVertexArray(first[k] * 3, (last[k] - first[k]) * 3);
     }
+    rlDisableVertexArray();
+    rlEnableBackfaceCulling();
+    rlDisableShader();
+}
+
+// --- MAIN GAME DRAWING ---
+
+static void PushBox(Vector2 c, float half, Color col) { PushSprite(SPRITE_SQUARE, c, half, half, 0, col); }
+static void PushDisc(Vector2 c, float r, Color col) { PushSprite(SPRITE_DISC, c, r, r, 0, col); }
+static void PushRing(Vector2 c, float r, Color col) { PushSprite(SPRITE_RING, c, r, r, 0, col); }
+
+void DrawGame(EntityStore* store, Rectangle* walls, int wallCount) {
+    float time = GetTime();
+    int count = store->count;
+
+    // 1. Draw standing water (one quad, see fluid.c)
+    DrawFluid();
 
     // 2. Draw Walls
     for (int i = 0; i < wallCount; i++) {
@@ -122,122 +313,88 @@ void DrawGame(Entity* entities, int count, Rectangle* walls, int wallCount) {
         DrawRectangleLinesEx(walls[i], 2, DARKGRAY);
     }
 
-    // 3. Draw Entities
+    // 3. Draw Entities: every chunk becomes quads from the sprite atlas, drawn in one batch
     for (int i = 0; i < count; i++) {
-        Entity* e = &entities[i];
-        if (!e->isActive || e->state == STATE_POOL) continue;
+        Entity* e = ENTITY(store, i);
+        if (!e->isActive) continue;
+        const EntityInfo* info = ENTITY_INFO(store, i);
 
         int chunks = GetSpellChunkCount(e);
-        SpellBehavior b = e->spellData.behavior;
+        SpellBehavior b = e->behavior;
         
         for(int k=0; k<chunks; k++) {
             Vector2 pos = GetSpellChunkPos(e, k, time);
             float size = GetSpellChunkSize(e, k);
             
             // SPELL VISUALS
-            switch(b){
-                SPELL_BERSERK:
-                    
-            }
-            if (b == SPELL_NECROMANCY) {
-                if (k == 0) {
-                    DrawCircleV(pos, size, LIGHTGRAY); DrawRectangle(pos.x-size/2, pos.y+size/2, size, size/2, LIGHTGRAY);
-                    DrawCircle(pos.x-4, pos.y, 3, BLACK); DrawCircle(pos.x+4, pos.y, 3, BLACK);
-                } else {
-                    DrawRectanglePro((Rectangle){pos.x, pos.y, 8, 3}, (Vector2){4,1.5}, time*50+k*30, LIGHTGRAY);
+            switch (b) {
+                case SPELL_NECROMANCY:
+                    if (k == 0) {
+                        PushDisc(pos, size, LIGHTGRAY); PushSprite(SPRITE_SQUARE, (Vector2){pos.x, pos.y+size*0.75f}, size/2, size/4, 0, LIGHTGRAY);
+                        PushDisc((Vector2){pos.x-4, pos.y}, 3, BLACK); PushDisc((Vector2){pos.x+4, pos.y}, 3, BLACK);
+                    } else {
+                        PushSprite(SPRITE_SQUARE, pos, 4, 1.5f, time*50+k*30, LIGHTGRAY);
+                    }
+                    continue;
+                case SPELL_VAMPIRISM: PushSprite(SPRITE_WEDGE, pos, 5, 5, 0, RED); continue;
+                case SPELL_SWARM: PushDisc(pos, size, BLACK); continue;
+                case SPELL_POISON: {
+                    float pulse = sinf(time*5.0f + k)*2.0f;
+                    PushDisc(pos, size + pulse, Fade(LIME, 0.6f)); PushRing(pos, size + pulse, GREEN);
+                    continue;
                 }
+                case SPELL_HEAL:
+                    PushSprite(SPRITE_SQUARE, pos, 2, 6, 0, GREEN); PushSprite(SPRITE_SQUARE, pos, 6, 2, 0, GREEN);
+                    continue;
+                case SPELL_TSUNAMI: PushDisc(pos, size, BLUE); PushRing(pos, size, WHITE); continue;
+                case SPELL_SNIPER:
+                    PushDisc(pos, size, RED);
+                    PushLine(pos, Vector2Subtract(pos, Vector2Scale(Vector2Normalize(e->velocity), 20)), 2.0f, RED);
+                    continue;
+                case SPELL_REWIND: PushRing(pos, size, GOLD); continue;
+                case SPELL_MIDAS: PushBox(pos, size, GOLD); PushSprite(SPRITE_SQUARE_LINES, pos, size, size, 0, YELLOW); continue;
+                case SPELL_VOID: PushDisc(pos, size + sinf(time*10)*2, BLACK); PushRing(pos, size + 5, PURPLE); continue;
+                case SPELL_WALL: PushBox(pos, size, DARKBROWN); PushSprite(SPRITE_SQUARE_LINES, pos, size, size, 0, BLACK); continue;
+                case SPELL_CHAIN_LIGHTNING:
+                    PushLine(pos, Vector2Add(pos, (Vector2){(float)GetRandomValue(-20,20), (float)GetRandomValue(-20,20)}), 2.0f, YELLOW);
+                    continue;
+                case SPELL_PHANTOM: PushBox(pos, size, Fade(WHITE, 0.3f)); continue;
+                case SPELL_PETRIFY: PushSprite(SPRITE_HEXAGON, pos, size, size, 0, GRAY); continue;
+                case SPELL_FREEZE: PushSprite(SPRITE_TRIANGLE, pos, size, size, time*90, SKYBLUE); continue;
+                case SPELL_GROWTH: PushDisc(pos, size, DARKGREEN); PushRing(pos, size+2, GREEN); continue;
+                case SPELL_SHRINK: PushRing(pos, size, PURPLE); PushDisc(pos, size/2, PURPLE); continue;
+                case SPELL_MAGNET: PushSprite(SPRITE_HALF_RING, pos, size, size, 0, GRAY); continue;
+                case SPELL_BOUNCE: PushDisc(pos, size, ORANGE); PushDisc(pos, size*0.5f, WHITE); continue;
+                case SPELL_LANDMINE: {
+                    Color c = (fmodf(time, 1.0f) > 0.5f) ? RED : GRAY; PushDisc(pos, size, GRAY); PushDisc(pos, 3, c);
+                    continue;
+                }
+                case SPELL_CLUSTER: PushDisc(pos, size, ORANGE); PushRing(pos, size, RED); continue;
+                default: break;
             }
-            else if (b == SPELL_VAMPIRISM) {
-                Vector2 v1 = {pos.x, pos.y - 5}; Vector2 v2 = {pos.x - 5, pos.y + 5}; Vector2 v3 = {pos.x + 5, pos.y + 5};
-                DrawTriangle(v1, v2, v3, RED);
-            }
-            else if (b == SPELL_SWARM) {
-                DrawCircleV(pos, size, BLACK); DrawLine(pos.x-3, pos.y, pos.x+3, pos.y, Fade(BLACK, 0.5f)); 
-            }
-            else if (b == SPELL_POISON) {
-                float pulse = sinf(time*5.0f + k)*2.0f;
-                DrawCircleV(pos, size + pulse, Fade(LIME, 0.6f)); DrawCircleLines(pos.x, pos.y, size + pulse, GREEN);
-            }
-            else if (b == SPELL_HEAL) {
-                DrawRectangle(pos.x-2, pos.y-6, 4, 12, GREEN); DrawRectangle(pos.x-6, pos.y-2, 12, 4, GREEN);
-            }
-            else if (b == SPELL_TSUNAMI) {
-                DrawCircleV(pos, size, BLUE); DrawCircleLines(pos.x, pos.y, size, WHITE);
-            }
-            else if (b == SPELL_SNIPER) {
-                DrawCircleV(pos, size, RED);
-                DrawLineEx(pos, Vector2Subtract(pos, Vector2Scale(Vector2Normalize(e->velocity), 20)), 2.0f, RED);
-            }
-            else if (b == SPELL_REWIND) {
-                DrawCircleLines(pos.x, pos.y, size, GOLD);
-            }
-            else if (b == SPELL_MIDAS) {
-                DrawRectangle(pos.x-size, pos.y-size, size*2, size*2, GOLD); DrawRectangleLines(pos.x-size, pos.y-size, size*2, size*2, YELLOW);
-            }
-            else if (b == SPELL_VOID) {
-                DrawCircleV(pos, size + sinf(time*10)*2, BLACK); DrawCircleLines(pos.x, pos.y, size + 5, PURPLE);
-            }
-            else if (b == SPELL_WALL) {
-                DrawRectangle(pos.x-size, pos.y-size, size*2, size*2, DARKBROWN); DrawRectangleLines(pos.x-size, pos.y-size, size*2, size*2, BLACK);
-            }
-            else if (b == SPELL_CHAIN_LIGHTNING) {
-                 DrawLineEx(pos, Vector2Add(pos, (Vector2){(float)GetRandomValue(-20,20), (float)GetRandomValue(-20,20)}), 2.0f, YELLOW);
-            }
-            else if (b == SPELL_PHANTOM) {
-                 DrawRectangle(pos.x-size, pos.y-size, size*2, size*2, Fade(WHITE, 0.3f));
-            }
-            else if (b == SPELL_PETRIFY) {
-                 DrawPoly(pos, 6, size, 0, GRAY);
-            }
-            else if (b == SPELL_FREEZE) {
-                 DrawPoly(pos, 3, size, time*90, SKYBLUE); 
-            }
-            else if (b == SPELL_GROWTH) {
-                 DrawCircleV(pos, size, DARKGREEN); DrawCircleLines(pos.x, pos.y, size+2, GREEN);
-            }
-            else if (b == SPELL_SHRINK) {
-                 DrawCircleLines(pos.x, pos.y, size, PURPLE); DrawCircleV(pos, size/2, PURPLE);
-            }
-            else if (b == SPELL_MAGNET) {
-                 DrawRing(pos, size-2, size, 0, 180, 10, GRAY);
-            }
-            else if (b == SPELL_BOUNCE) {
-                 DrawCircleV(pos, size, ORANGE); DrawCircleV(pos, size*0.5f, WHITE); 
-            }
-            else if (b == SPELL_LANDMINE) {
-                 Color c = (fmodf(time, 1.0f) > 0.5f) ? RED : GRAY; DrawCircleV(pos, size, GRAY); DrawCircleV(pos, 3, c);
-            }
-            else if (b == SPELL_CLUSTER) {
-                 DrawCircleV(pos, size, ORANGE); DrawCircleLines(pos.x, pos.y, size, RED);
-            }
-            else if (e->spellData.core == ELEM_FIRE) {
+            // Everything else looks like its element
+            if (e->element == ELEM_FIRE) {
                 float f = sinf(time*30+k);
-                DrawRectangle(pos.x-size, pos.y-size, size*2, size*2, (f>0)?RED:ORANGE);
+                PushBox(pos, size, (f>0)?RED:ORANGE);
             }
-            else if (e->spellData.core == ELEM_WATER) {
-                DrawRectangle(pos.x-size, pos.y-size, size*2, size*2, Fade(BLUE, 0.8f));
-            }
-            else if (e->spellData.core == ELEM_AIR) {
-                 DrawCircleV(pos, size, Fade(SKYBLUE, 0.5f));
-            }
-            else if (e->spellData.core == ELEM_EARTH) {
-                 DrawRectangle(pos.x-size, pos.y-size, size*2, size*2, DARKBROWN);
-                 DrawRectangleLines(pos.x-size, pos.y-size, size*2, size*2, BLACK);
-            }
-            else {
-                 DrawRectangle(pos.x-size, pos.y-size, size*2, size*2, e->color);
+            else if (e->element == ELEM_WATER) PushBox(pos, size, Fade(BLUE, 0.8f));
+            else if (e->element == ELEM_AIR) PushDisc(pos, size, Fade(SKYBLUE, 0.5f));
+            else if (e->element == ELEM_EARTH) {
+                PushBox(pos, size, DARKBROWN); PushSprite(SPRITE_SQUARE_LINES, pos, size, size, 0, BLACK);
             }
+            else PushBox(pos, size, info->color);
         }
         
         // Draw Connecting Lines
         if (e->state == STATE_PROJECTILE && b != SPELL_SWARM && b != SPELL_SNIPER && b != SPELL_TSUNAMI) {
-            for(int j=0; j < e->spellData.auxCount; j++) {
-                float angle = (time * 3.0f) + (j * (PI * 2 / e->spellData.auxCount));
+            for(int j=0; j < info->spellData.auxCount; j++) {
+                float angle = (time * 3.0f) + (j * (PI * 2 / info->spellData.auxCount));
                 Vector2 offset = { cosf(angle)*30.0f, sinf(angle)*30.0f };
                 Vector2 orbPos = Vector2Add(e->position, offset);
-                DrawLineEx(e->position, orbPos, 1.0f, Fade(BLACK, 0.2f));
-                DrawRectangle(orbPos.x-3, orbPos.y-3, 6, 6, GetElementColor(e->spellData.aux[j]));
+                PushLine(e->position, orbPos, 1.0f, Fade(BLACK, 0.2f));
+                PushBox(orbPos, 3, GetElementColor(info->spellData.aux[j]));
             }
         }
     }
-}
\ No newline at end of file
+    FlushSprites();
+}
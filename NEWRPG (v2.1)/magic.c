@@ -10,37 +10,39 @@ Color GetElementColor(ElementType type) {
     }
 }
 
-Entity CreateRawElement(ElementType type, Vector2 pos) {
-    Entity e = {0};
-    e.position = pos;
-    e.state = STATE_RAW;
-    e.isActive = true;
-    e.mass = 20.0f; e.friction = 5.0f; e.size = 15.0f;
-    e.color = GetElementColor(type);
-    e.maxSpeed = 0.0f; e.moveForce = 0.0f;
-    e.spellData.core = type;
-    e.spellData.auxCount = 0;
-    if(type == ELEM_FIRE) { e.spellData.temperature = 100.0; e.spellData.dryness = 1.0; }
-    else if(type == ELEM_WATER) { e.spellData.temperature = 20.0; e.spellData.dryness = 0.0; }
-    else if(type == ELEM_EARTH) { e.spellData.temperature = 50.0; e.spellData.dryness = 1.0; }
-    else if(type == ELEM_AIR) { e.spellData.temperature = 40.0; e.spellData.dryness = 0.5; }
-    e.spellData.intensity = 0.5;
-    return e;
+EntityData CreateRawElement(ElementType type, Vector2 pos) {
+    EntityData d = {0};
+    Entity* e = &d.hot; Spell* s = &d.cold.spellData;
+    e->position = pos;
+    e->state = STATE_RAW;
+    e->isActive = true;
+    e->mass = 20.0f; e->friction = 5.0f; e->size = 15.0f;
+    d.cold.color = GetElementColor(type);
+    e->maxSpeed = 0.0f; e->moveForce = 0.0f;
+    s->core = type;
+    s->auxCount = 0;
+    if(type == ELEM_FIRE) { s->temperature = 100.0; s->dryness = 1.0; }
+    else if(type == ELEM_WATER) { s->temperature = 20.0; s->dryness = 0.0; }
+    else if(type == ELEM_EARTH) { s->temperature = 50.0; s->dryness = 1.0; }
+    else if(type == ELEM_AIR) { s->temperature = 40.0; s->dryness = 0.5; }
+    s->intensity = 0.5;
+    SyncEntityKind(e, s);
+    return d;
 }
 
 int GetSpellChunkCount(Entity* e) {
     if (e->state == STATE_RAW) return 3;
     if (e->state == STATE_PROJECTILE) {
-        SpellBehavior b = e->spellData.behavior;
+        SpellBehavior b = e->behavior;
         if (b == SPELL_SWARM || b == SPELL_CLUSTER || b == SPELL_POISON) return 20;
         if (b == SPELL_TSUNAMI || b == SPELL_WALL) return 15;
         if (b == SPELL_SNIPER || b == SPELL_VOID || b == SPELL_BOUNCE) return 1;
         if (b == SPELL_MIRROR) return 2;
         if (b == SPELL_NECROMANCY) return 5;
-        if (e->spellData.core == ELEM_FIRE) return 12;
-        if (e->spellData.core == ELEM_EARTH || b == SPELL_MIDAS) return 8;
-        if (e->spellData.core == ELEM_WATER) return 8;
-        if (e->spellData.core == ELEM_AIR) return 6;
+        if (e->element == ELEM_FIRE) return 12;
+        if (e->element == ELEM_EARTH || b == SPELL_MIDAS) return 8;
+        if (e->element == ELEM_WATER) return 8;
+        if (e->element == ELEM_AIR) return 6;
         return 6; 
     }
     return 1; 
@@ -48,7 +50,7 @@ int GetSpellChunkCount(Entity* e) {
 
 Vector2 GetSpellChunkPos(Entity* e, int index, float time) {
     Vector2 center = e->position;
-    SpellBehavior b = e->spellData.behavior;
+    SpellBehavior b = e->behavior;
     if (e->state == STATE_RAW) {
         float offX = sinf(index * 99.0f + time * 2.0f) * 8.0f;
         float offY = cosf(index * 13.0f + time * 2.0f) * 8.0f;
@@ -86,7 +88,7 @@ Vector2 GetSpellChunkPos(Entity* e, int index, float time) {
         }
         float angle = (time * (b == SPELL_WHIRLWIND ? 15.0f : 2.0f)) + (index * (PI*2 / GetSpellChunkCount(e)));
         float dist = e->size + sinf(time*5.0f + index)*5.0f;
-        if (e->spellData.core == ELEM_FIRE && b == SPELL_PROJECTILE) { 
+        if (e->element == ELEM_FIRE && b == SPELL_PROJECTILE) { 
              float jitterX = sinf(time * 20.0f + index) * 10.0f;
              return Vector2Add(center, (Vector2){jitterX, -index * 2.0f});
         }
@@ -97,7 +99,7 @@ Vector2 GetSpellChunkPos(Entity* e, int index, float time) {
 
 float GetSpellChunkSize(Entity* e, int index) {
     if (e->state == STATE_RAW) return e->size * 0.6f;
-    SpellBehavior b = e->spellData.behavior;
+    SpellBehavior b = e->behavior;
     if (b == SPELL_VOID) return e->size * 1.5f;
     if (b == SPELL_SNIPER) return 4.0f;
     if (b == SPELL_SWARM) return 3.0f;
@@ -109,7 +111,7 @@ float GetSpellChunkSize(Entity* e, int index) {
 
 void ApplyElementPhysics(Entity* e) {
     e->moveForce = 2000.0f;
-    switch (e->spellData.core) {
+    switch (e->element) {
         case ELEM_FIRE: e->mass = 1.0f; e->maxSpeed = 1000.0f; e->friction = 1.0f; break;
         case ELEM_EARTH: e->mass = 50.0f; e->maxSpeed = 500.0f; e->friction = 10.0f; break;
         case ELEM_WATER: e->mass = 10.0f; e->maxSpeed = 700.0f; e->friction = 2.0f; break;
@@ -118,82 +120,144 @@ void ApplyElementPhysics(Entity* e) {
     }
 }
 
-void RecalculateStats(Spell* s) {
-    s->power = 10.0f; s->aiType = AI_LINEAR; s->behavior = SPELL_PROJECTILE;
-    s->isTeleport = false; s->hasHoming = false; s->hasGravity = false;
+// --- FUSION TABLE ---
+// What a spell becomes depends only on its core and how many of each element
+// are in its aux list. The rules only ever ask whether a count is 0, 1 or at
+// least 2 (and whether there is any aux at all), so counts saturate at 2 and
+// the whole input space is 5 cores x 3^4 count tuples x 2 = 810 entries. The
+// table is filled once from the rules below; fusion, the compendium recipes
+// and the tooltips all read it.
+
+#define FUSION_LEVELS 3 // Count 0, 1, 2+
+#define FUSION_KEYS (5 * FUSION_LEVELS * FUSION_LEVELS * FUSION_LEVELS * FUSION_LEVELS * 2)
+
+typedef struct {
+    unsigned char behavior, aiType; // SpellBehavior, AiType
+    bool isTeleport, hasHoming, hasGravity;
+} FusionOutcome;
+
+static FusionOutcome fusionTable[FUSION_KEYS];
+static bool fusionTableReady = false;
+
+static int FusionKey(ElementType core, const int count[5], bool anyAux) {
+    int key = core;
+    for (int el = ELEM_EARTH; el <= ELEM_AIR; el++) key = key * FUSION_LEVELS + (count[el] < 2 ? count[el] : 2);
+    return key * 2 + anyAux;
+}
+
+// The fusion rules, in priority order. Only used to fill the table.
+static FusionOutcome DecideFusion(ElementType core, int earth, int water, int fire, int air, bool anyAux) {
+    FusionOutcome o = { SPELL_PROJECTILE, AI_LINEAR, false, false, false };
+
+    if (air >= 2) { o.aiType = AI_HOMING; o.hasHoming = true; }
+    if (air >= 1 && fire >= 1) o.aiType = AI_PREDICT; 
+    if (water >= 2) o.aiType = AI_ORBIT;       
+    if (earth >= 2 && fire >= 1) o.aiType = AI_ERRATIC; 
+    if (water >= 1 && air >= 1 && earth >= 1) o.aiType = AI_SWARM;
     
-    int air = 0, earth = 0, water = 0, fire = 0;
-    for(int i=0; i<s->auxCount; i++) {
-        if(s->aux[i] == ELEM_FIRE) fire++;
-        if(s->aux[i] == ELEM_AIR) air++;
-        if(s->aux[i] == ELEM_EARTH) earth++;
-        if(s->aux[i] == ELEM_WATER) water++;
+    if (core == ELEM_EARTH) {
+        if (air >= 2) o.isTeleport = true; 
+        else if (earth >= 2) o.behavior = SPELL_PETRIFY;
+        else if (earth >= 1) o.behavior = SPELL_WALL;
+        else if (water >= 2) o.behavior = SPELL_GROWTH;
+        else if (fire >= 1 && air == 0) o.behavior = SPELL_LANDMINE;
+        else if (water >= 1 && air >= 1) o.behavior = SPELL_REWIND;
+        else if (air >= 1 && fire >= 1) o.behavior = SPELL_MAGNET;
     }
-    
-    if (air >= 2) { s->aiType = AI_HOMING; s->hasHoming = true; }
-    if (air >= 1 && fire >= 1) s->aiType = AI_PREDICT; 
-    if (water >= 2) s->aiType = AI_ORBIT;       
-    if (earth >= 2 && fire >= 1) s->aiType = AI_ERRATIC; 
-    if (water >= 1 && air >= 1 && earth >= 1) s->aiType = AI_SWARM;
-    
-    if (s->core == ELEM_EARTH) {
-        if (air >= 2) s->isTeleport = true; 
-        else if (earth >= 2) s->behavior = SPELL_PETRIFY;
-        else if (earth >= 1) s->behavior = SPELL_WALL;
-        else if (water >= 2) s->behavior = SPELL_GROWTH;
-        else if (fire >= 1 && air == 0) s->behavior = SPELL_LANDMINE;
-        else if (water >= 1 && air >= 1) s->behavior = SPELL_REWIND;
-        else if (air >= 1 && fire >= 1) s->behavior = SPELL_MAGNET;
+    else if (core == ELEM_FIRE) {
+        if (earth >= 1 && fire == 0) o.behavior = SPELL_MIDAS;
+        else if (fire >= 2) o.behavior = SPELL_BERSERK;
+        else if (fire >= 1 && earth >= 1) o.behavior = SPELL_CLUSTER;
+        else if (air >= 2) o.behavior = SPELL_VOID;
+        else if (air >= 1 && earth == 0) o.behavior = SPELL_CHAIN_LIGHTNING;
+        else if (water >= 1 && air >= 1) o.behavior = SPELL_CONFUSE;
+        else if (air >= 1) o.behavior = SPELL_SHRINK;
     }
-    else if (s->core == ELEM_FIRE) {
-        if (earth >= 1 && fire == 0) s->behavior = SPELL_MIDAS;
-        else if (fire >= 2) s->behavior = SPELL_BERSERK;
-        else if (fire >= 1 && earth >= 1) s->behavior = SPELL_CLUSTER;
-        else if (air >= 2) s->behavior = SPELL_VOID;
-        else if (air >= 1 && earth == 0) s->behavior = SPELL_CHAIN_LIGHTNING;
-        else if (water >= 1 && air >= 1) s->behavior = SPELL_CONFUSE;
-        else if (air >= 1) s->behavior = SPELL_SHRINK;
+    else if (core == ELEM_WATER) {
+        if (water >= 2) o.behavior = SPELL_TSUNAMI;
+        else if (air >= 1 && earth == 0 && fire == 0) o.behavior = SPELL_FREEZE;
+        else if (fire >= 1 && earth >= 1) o.behavior = SPELL_VAMPIRISM;
+        else if (earth >= 1 && fire == 0) o.behavior = SPELL_BOUNCE;
+        else if (air >= 1 && earth >= 1) o.behavior = SPELL_SWARM;
+        else if (earth >= 1 && fire >= 1) o.behavior = SPELL_POISON;
+        else if (air >= 1 && fire >= 1) o.behavior = SPELL_MIRROR;
+        else if (anyAux) o.behavior = SPELL_HEAL;
     }
-    else if (s->core == ELEM_WATER) {
-        if (water >= 2) s->behavior = SPELL_TSUNAMI;
-        else if (air >= 1 && earth == 0 && fire == 0) s->behavior = SPELL_FREEZE;
-        else if (fire >= 1 && earth >= 1) s->behavior = SPELL_VAMPIRISM;
-        else if (earth >= 1 && fire == 0) s->behavior = SPELL_BOUNCE;
-        else if (air >= 1 && earth >= 1) s->behavior = SPELL_SWARM;
-        else if (earth >= 1 && fire >= 1) s->behavior = SPELL_POISON;
-        else if (air >= 1 && fire >= 1) s->behavior = SPELL_MIRROR;
-        else if (s->auxCount > 0) s->behavior = SPELL_HEAL;
+    else if (core == ELEM_AIR) {
+        if (air >= 2) o.behavior = SPELL_WHIRLWIND;
+        else if (air >= 1 && fire == 0) { o.behavior = SPELL_TELEKINESIS; o.hasGravity = true; }
+        else if (water >= 1 && earth == 0) o.behavior = SPELL_PHANTOM; 
+        else if (fire >= 1 && earth >= 1) o.behavior = SPELL_SNIPER;
     }
-    else if (s->core == ELEM_AIR) {
-        if (air >= 2) s->behavior = SPELL_WHIRLWIND;
-        else if (air >= 1 && fire == 0) { s->behavior = SPELL_TELEKINESIS; s->hasGravity = true; }
-        else if (water >= 1 && earth == 0) s->behavior = SPELL_PHANTOM; 
-        else if (fire >= 1 && earth >= 1) s->behavior = SPELL_SNIPER;
+    return o;
+}
+
+static void BuildFusionTable() {
+    for (int core = ELEM_NONE; core <= ELEM_AIR; core++) {
+        for (int key = 0; key < FUSION_KEYS / 5; key++) {
+            int anyAux = key & 1, rest = key >> 1;
+            int air = rest % FUSION_LEVELS, fire = rest / FUSION_LEVELS % FUSION_LEVELS;
+            int water = rest / (FUSION_LEVELS * FUSION_LEVELS) % FUSION_LEVELS, earth = rest / (FUSION_LEVELS * FUSION_LEVELS * FUSION_LEVELS);
+            fusionTable[core * (FUSION_KEYS / 5) + key] = DecideFusion((ElementType)core, earth, water, fire, air, anyAux || earth + water + fire + air > 0);
+        }
+    }
+    fusionTableReady = true;
+}
+
+void RecalculateStats(Spell* s) {
+    if (!fusionTableReady) BuildFusionTable();
+    int count[5] = { 0 };
+    for (int i = 0; i < s->auxCount; i++) count[s->aux[i]]++;
+    const FusionOutcome* o = &fusionTable[FusionKey(s->core, count, s->auxCount > 0)];
+    s->power = 10.0f; s->behavior = o->behavior; s->aiType = o->aiType;
+    s->isTeleport = o->isTeleport; s->hasHoming = o->hasHoming; s->hasGravity = o->hasGravity;
+}
+
+// The smallest aux mix that makes behavior: its core and count per element.
+// False if no mix does.
+bool GetFusionRecipe(SpellBehavior behavior, ElementType* core, int count[5]) {
+    if (!fusionTableReady) BuildFusionTable();
+    for (int total = 1; total <= 2 * 4; total++) {
+        for (int c = ELEM_EARTH; c <= ELEM_AIR; c++) {
+            for (int key = 0; key < FUSION_KEYS / 5; key += 2) {
+                int rest = key >> 1, n[5] = { 0 };
+                for (int el = ELEM_AIR; el >= ELEM_EARTH; el--) { n[el] = rest % FUSION_LEVELS; rest /= FUSION_LEVELS; }
+                if (n[ELEM_EARTH] + n[ELEM_WATER] + n[ELEM_FIRE] + n[ELEM_AIR] != total) continue;
+                if (fusionTable[c * (FUSION_KEYS / 5) + key + 1].behavior != behavior) continue;
+                *core = (ElementType)c;
+                memcpy(count, n, sizeof(n));
+                return true;
+            }
+        }
     }
+    return false;
 }
 
-void PerformSpatialFusion(Entity* entities, int count, int coreIndex, ParticleSystem* ps, Player* player) {
-    Entity* core = &entities[coreIndex];
-    Spell* s = &core->spellData;
+void PerformSpatialFusion(EntityStore* store, int coreIndex, ParticleSystem* ps, Player* player) {
+    Entity* core = ENTITY(store, coreIndex);
+    Spell* s = &ENTITY_INFO(store, coreIndex)->spellData;
     double totalTemp = s->temperature * s->intensity;
     double totalDry = s->dryness * s->intensity;
     double totalInt = s->intensity;
 
-    for(int i = 1; i < count; i++) {
-        if (i == coreIndex) continue; 
-        if (!entities[i].isActive || entities[i].state != STATE_RAW) continue;
-        float dist = Vector2Distance(core->position, entities[i].position);
-        if (dist < FUSION_RADIUS) {
-            if (s->auxCount < MAX_AUX) s->aux[s->auxCount++] = entities[i].spellData.core;
-            totalTemp += entities[i].spellData.temperature * entities[i].spellData.intensity;
-            totalDry += entities[i].spellData.dryness * entities[i].spellData.intensity;
-            totalInt += entities[i].spellData.intensity;
-            SpawnExplosion(ps, entities[i].position, entities[i].color);
-            entities[i].isActive = false; 
-        }
+    const int* nearby; // From the spatial index, in index order like the old scan
+    int nearbyCount = QueryRadius(core->position, FUSION_RADIUS, &nearby);
+    for(int k = 0; k < nearbyCount; k++) {
+        int i = nearby[k];
+        if (i == 0 || i == coreIndex || i >= store->count) continue; 
+        Entity* e = ENTITY(store, i);
+        if (!e->isActive || e->state != STATE_RAW) continue;
+        Spell* other = &ENTITY_INFO(store, i)->spellData;
+        if (s->auxCount < MAX_AUX) s->aux[s->auxCount++] = other->core;
+        totalTemp += other->temperature * other->intensity;
+        totalDry += other->dryness * other->intensity;
+        totalInt += other->intensity;
+        SpawnExplosion(ps, e->position, ENTITY_INFO(store, i)->color);
+        e->isActive = false; 
     }
     if(totalInt > 0) { s->temperature = totalTemp/totalInt; s->dryness = totalDry/totalInt; s->intensity = totalInt; }
     RecalculateStats(s);
+    SyncEntityKind(core, s);
     core->state = STATE_PROJECTILE; core->size = 25.0f; core->isSpell = true; 
     ApplyElementPhysics(core);
     sprintf(s->name, "Fused Spell");
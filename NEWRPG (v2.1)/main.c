@@ -3,45 +3,65 @@
 // Limit entities for cleanup logic 
 #define PICKUP_RANGE 100.0f 
 
-void CleanupEntities(Entity* entities, int* count) {
-    for (int i = 1; i < *count; i++) {
-        // Remove inactive or out-of-bounds entities
-        if (!entities[i].isActive || entities[i].position.y > SCREEN_HEIGHT + 50) {
-            entities[i] = entities[*count - 1]; (*count)--; i--; 
-        }
+void CleanupEntities(EntityStore* store) {
+    for (int i = 1; i < store->count; i++) {
+        // Free inactive or out-of-bounds entities (a freed slot just stays inactive)
+        Entity* e = ENTITY(store, i);
+        if (!e->isActive || e->position.y > SCREEN_HEIGHT + 50) DespawnEntity(store, i);
+    }
+}
+
+typedef enum { PICK_RAW, PICK_HOVER, PICK_ANY } PickFilter;
+
+// First entity under p (never the player) that passes the filter, or -1.
+// Queries afresh, since fusion reuses the index's result buffer.
+static int PickEntity(EntityStore* store, Vector2 p, PickFilter filter) {
+    const int* hits;
+    int hitCount = QueryPoint(p, &hits);
+    for (int k = 0; k < hitCount; k++) {
+        Entity* e = ENTITY(store, hits[k]);
+        if (hits[k] == 0) continue;
+        if (filter == PICK_RAW ? e->state == STATE_RAW : (e->isActive && (filter == PICK_ANY || !e->isHeld))) return hits[k];
     }
+    return -1;
 }
 
 int main() {
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Hybrid Magic - Complete Edition");
     SetTargetFPS(60); 
 
-    Entity entities[MAX_ENTITIES];
-    int entityCount = 0;
+    // The big pools live on the heap, booked per subsystem (see memory.c)
+    EntityStore store; InitEntityStore(&store);
 
     // Player
-    entities[entityCount++] = (Entity){
-        .position = {100, 100}, .velocity = {0,0}, 
-        .mass = 1.0f, .friction = 10.0f, .size = 30.0f, 
-        .maxSpeed = 600.0f, .moveForce = 3000.0f,
-        .color = MAROON, .isActive = true, .state = STATE_RAW, .health = 100, .maxHealth = 100
-    };
-    Entity* player = &entities[0];
+    SpawnEntity(&store, (EntityData){
+        .hot = { .position = {100, 100}, .velocity = {0,0}, 
+                 .mass = 1.0f, .friction = 10.0f, .size = 30.0f, 
+                 .maxSpeed = 600.0f, .moveForce = 3000.0f, .isActive = true, .state = STATE_RAW },
+        .cold = { .color = MAROON, .health = 100, .maxHealth = 100 }
+    });
+    Entity* player = ENTITY(&store, 0); // Slots never move
     Player playerData = { .selectedElement = ELEM_EARTH, .mana = 100, .maxMana = 100 };
     
     playerData.book.scrollY = 0;
     for(int i=0; i<SPELL_COUNT; i++) playerData.book.discovered[i] = false;
 
     // Systems Init
-    GrassSystem grass; InitGrass(&grass);
+    GrassSystem* grass = TagCalloc(MEM_WORLD, 1, sizeof(GrassSystem)); InitGrass(grass);
     Inventory inventory = { 0 }; InitInventory(&inventory);
-    ParticleSystem particleSystem; InitParticles(&particleSystem);
+    ParticleSystem* particleSystem = TagCalloc(MEM_PARTICLES, 1, sizeof(ParticleSystem)); InitParticles(particleSystem);
+    InitFluid(); InitSpriteAtlas();
     
     // Walls
     Rectangle walls[WALL_COUNT] = { {200, 450, 400, 50}, {150, 150, 50, 300}, {600, 300, 50, 200} };
     Camera2D camera = { 0 }; camera.zoom = 1.0f; camera.offset = (Vector2){SCREEN_WIDTH/2, SCREEN_HEIGHT/2};
     
     bool showCompendium = false;
+    bool showMemory = false;
+
+    // Entities under the mouse come from the spatial index. It is built after
+    // cleanup, so it holds for the draw and for the next frame's input.
+    BuildSpatialIndex(&store);
 
     while (!WindowShouldClose()) {
         Vector2 mouseScreen = GetMousePosition();
@@ -49,6 +69,7 @@ int main() {
         camera.target = player->position;
         
         if (IsKeyPressed(KEY_C)) showCompendium = !showCompendium;
+        if (IsKeyPressed(KEY_F3)) showMemory = !showMemory;
         
         if (IsKeyPressed(KEY_F1)) {
             for(int i=0; i<SPELL_COUNT; i++) playerData.book.discovered[i] = true;
@@ -59,30 +80,29 @@ int main() {
         if (!showCompendium) {
             bool isSelecting = IsKeyDown(KEY_TAB);
             
-            UpdateGrass(&grass, entities, entityCount);
+            UpdateGrass(grass, &store);
             
-            if (!isSelecting && IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && entityCount < MAX_ENTITIES) {
+            if (!isSelecting && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
                 if (playerData.selectedElement != ELEM_NONE) {
-                    entities[entityCount++] = CreateRawElement(playerData.selectedElement, mouseWorld);
+                    SpawnEntity(&store, CreateRawElement(playerData.selectedElement, mouseWorld));
                 }
             }
             if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)) {
-                for (int i = 1; i < entityCount; i++) {
-                    if (entities[i].state == STATE_RAW && CheckCollisionPointCircle(mouseWorld, entities[i].position, entities[i].size)) {
-                        PerformSpatialFusion(entities, entityCount, i, &particleSystem, &playerData);
-                        Vector2 dir = Vector2Normalize(Vector2Subtract(mouseWorld, player->position)); 
-                        entities[i].velocity = Vector2Scale(dir, entities[i].maxSpeed);
-                        break; 
-                    }
+                int i = PickEntity(&store, mouseWorld, PICK_RAW);
+                if (i != -1) {
+                    PerformSpatialFusion(&store, i, particleSystem, &playerData);
+                    Vector2 dir = Vector2Normalize(Vector2Subtract(mouseWorld, player->position)); 
+                    ENTITY(&store, i)->velocity = Vector2Scale(dir, ENTITY(&store, i)->maxSpeed);
                 }
             }
             if (IsKeyPressed(KEY_T)) {
-                for (int i = 1; i < entityCount; i++) {
-                    if (entities[i].isActive && entities[i].spellData.isTeleport) {
-                        SpawnExplosion(&particleSystem, player->position, PURPLE);
-                        player->position = entities[i].position; player->velocity = (Vector2){0,0};
-                        SpawnExplosion(&particleSystem, player->position, ORANGE);
-                        entities[i].isActive = false; break;
+                for (int i = 1; i < store.count; i++) {
+                    Entity* e = ENTITY(&store, i);
+                    if (e->isActive && ENTITY_INFO(&store, i)->spellData.isTeleport) {
+                        SpawnExplosion(particleSystem, player->position, PURPLE);
+                        player->position = e->position; player->velocity = (Vector2){0,0};
+                        SpawnExplosion(particleSystem, player->position, ORANGE);
+                        e->isActive = false; break;
                     }
                 }
             }
@@ -91,17 +111,14 @@ int main() {
             for (int i = 0; i < INVENTORY_CAPACITY; i++) {
                 if (IsKeyPressed(KEY_ONE + i)) if (i < inventory.count) inventory.selectedSlot = (inventory.selectedSlot == i) ? -1 : i;
             }
-            int hovered = -1;
-            for (int i = 1; i < entityCount; i++) {
-                if (entities[i].isActive && !entities[i].isHeld && CheckCollisionPointCircle(mouseWorld, entities[i].position, entities[i].size)) { hovered = i; break; }
-            }
+            int hovered = PickEntity(&store, mouseWorld, PICK_HOVER);
             if (IsKeyPressed(KEY_E) && hovered != -1) {
-                if (AddItem(&inventory, entities[hovered])) { entities[hovered] = entities[entityCount - 1]; entityCount--; hovered = -1; }
+                if (AddItem(&inventory, GetEntityData(&store, hovered))) { DespawnEntity(&store, hovered); hovered = -1; }
             }
             if (IsKeyPressed(KEY_Q) && inventory.selectedSlot != -1) {
-                Entity dropped = DropItem(&inventory, inventory.selectedSlot);
-                dropped.position = mouseWorld; dropped.isActive = true; dropped.velocity = (Vector2){0,0}; dropped.moveForce = 0.0f; 
-                if(entityCount < MAX_ENTITIES) entities[entityCount++] = dropped;
+                EntityData dropped = DropItem(&inventory, inventory.selectedSlot);
+                dropped.hot.position = mouseWorld; dropped.hot.isActive = true; dropped.hot.velocity = (Vector2){0,0}; dropped.hot.moveForce = 0.0f; 
+                SpawnEntity(&store, dropped);
             }
 
             Vector2 input = {0,0};
@@ -109,58 +126,59 @@ int main() {
             if (IsKeyDown(KEY_A)) input.x -= 1; if (IsKeyDown(KEY_D)) input.x += 1;
             UpdateEntityPhysics(player, input, walls, WALL_COUNT);
 
-            for(int i=1; i<entityCount; i++) {
-                if(entities[i].isActive) {
-                    UpdateEntityAI(&entities[i], entities, entityCount, player->position);
-                    UpdateEntityPhysics(&entities[i], (Vector2){0,0}, walls, WALL_COUNT);
-                }
+            UpdateSteering(&store, player->position, player->velocity, GetFrameTime());
+            for(int i=1; i<store.count; i++) {
+                if(ENTITY(&store, i)->isActive) UpdateEntityPhysics(ENTITY(&store, i), (Vector2){0,0}, walls, WALL_COUNT);
             }
-            ApplySpellFieldEffects(entities, entityCount, &particleSystem);
-            ResolveEntityCollisions(entities, &entityCount, player, &particleSystem);
-            UpdateParticles(&particleSystem);
-            CleanupEntities(entities, &entityCount);
+            ApplySpellFieldEffects(&store, particleSystem);
+            ResolveEntityCollisions(&store, particleSystem);
+            UpdateParticles(particleSystem, GetFrameTime());
+            UpdateFluid(GetFrameTime());
+            CleanupEntities(&store);
+            BuildSpatialIndex(&store);
         }
 
         BeginDrawing();
             ClearBackground((Color){ 20, 25, 30, 255 }); // Dark Green
             BeginMode2D(camera);
-                DrawGrass(&grass);
-                DrawGame(entities, entityCount, walls, WALL_COUNT);
-                DrawParticles(&particleSystem);
+                DrawGrass(grass, camera);
+                DrawGame(&store, walls, WALL_COUNT);
+                DrawParticles(particleSystem);
                 
-                int hovered = -1; 
-                for (int i = 1; i < entityCount; i++) {
-                    if (entities[i].isActive && !entities[i].isHeld && CheckCollisionPointCircle(mouseWorld, entities[i].position, entities[i].size)) { hovered = i; break; }
-                }
+                int hovered = PickEntity(&store, mouseWorld, PICK_HOVER); 
                 if (hovered != -1) {
-                    Entity e = entities[hovered]; float r = e.size + 5;
+                    Entity e = *ENTITY(&store, hovered); float r = e.size + 5;
                     DrawRectangleLines(e.position.x-r, e.position.y-r, r*2, r*2, YELLOW);
                     DrawText("E", e.position.x-r, e.position.y-r-20, 20, YELLOW);
                 }
-                for(int i=1; i<entityCount; i++) {
-                    if(entities[i].state == STATE_RAW && CheckCollisionPointCircle(mouseWorld, entities[i].position, entities[i].size)) {
-                        DrawCircleLines(entities[i].position.x, entities[i].position.y, FUSION_RADIUS, Fade(GREEN, 0.5f));
+                const int* hits;
+                int hitCount = QueryPoint(mouseWorld, &hits);
+                for(int k=0; k<hitCount; k++) {
+                    Entity* e = ENTITY(&store, hits[k]);
+                    if(hits[k] > 0 && e->state == STATE_RAW) {
+                        DrawCircleLines(e->position.x, e->position.y, FUSION_RADIUS, Fade(GREEN, 0.5f));
                     }
                 }
             EndMode2D();
             
             DrawInventory(&inventory, SCREEN_WIDTH/2 - 100, SCREEN_HEIGHT - 80);
-            DrawHUD(player, &playerData);
+            DrawHUD(ENTITY_INFO(&store, 0), &playerData);
 
             if (IsKeyDown(KEY_TAB)) DrawElementWheel(&playerData, mouseScreen);
             else { DrawRectangle(SCREEN_WIDTH - 60, SCREEN_HEIGHT - 60, 40, 40, GetElementColor(playerData.selectedElement)); DrawText("TAB", SCREEN_WIDTH - 55, SCREEN_HEIGHT - 45, 10, BLACK); }
             
-            int hovered2 = -1;
-            for (int i = 1; i < entityCount; i++) {
-                if (entities[i].isActive && CheckCollisionPointCircle(mouseWorld, entities[i].position, entities[i].size)) { hovered2 = i; break; }
-            }
-            if (hovered2 != -1) DrawEntityTooltip(&entities[hovered2], mouseScreen.x, mouseScreen.y);
+            int hovered2 = PickEntity(&store, mouseWorld, PICK_ANY);
+            if (hovered2 != -1) DrawEntityTooltip(ENTITY(&store, hovered2), ENTITY_INFO(&store, hovered2), mouseScreen.x, mouseScreen.y);
             
             if (showCompendium) DrawCompendium(&playerData);
+            if (showMemory) DrawMemoryPanel();
 
             DrawFPS(10, 10);
         EndDrawing();
+        MemoryEndFrame();
     }
+    PrintMemoryReport(stdout);
+    FreeEntityStore(&store); TagFree(grass); TagFree(particleSystem); UnloadFluid(); UnloadGrassMesh(); UnloadSpriteAtlas(); ShutdownSteering();
     CloseWindow();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "game.h"
+
+// --- MEMORY ACCOUNTING ---
+// Entities, grass and particles are allocated with a tag instead of living
+// on main()'s stack. Each block starts with a small header holding its size
+// and tag, so TagFree knows what to take off the books. Fixed arrays are
+// registered once with TrackStatic. Single-threaded, so no locking.
+
+#define MEM_HEADER 16 // Keeps blocks 16-byte aligned
+#define MEM_MAX_STATICS 16
+
+const char* MemTagNames[MEM_TAG_COUNT] = { "world", "render", "entities", "particles", "ui" };
+
+typedef struct { size_t size; int tag; } BlockHeader;
+typedef struct { const char* name; MemTag tag; size_t bytes; } StaticBlock;
+
+static MemoryStats tags[MEM_TAG_COUNT];
+static int pendingAllocs[MEM_TAG_COUNT];
+static size_t pendingBytes[MEM_TAG_COUNT], windowBytes[MEM_TAG_COUNT];
+static float windowSeconds = 0;
+static StaticBlock statics[MEM_MAX_STATICS];
+static int staticCount = 0;
+
+static void Book(MemTag tag, long long bytes) {
+    MemoryStats* s = &tags[tag];
+    s->live += bytes;
+    if (s->live > s->peak) s->peak = s->live;
+    if (bytes > 0) { s->allocs++; s->allocated += bytes; pendingAllocs[tag]++; pendingBytes[tag] += bytes; }
+}
+
+void* TagCalloc(MemTag tag, size_t count, size_t size) {
+    BlockHeader* h = calloc(1, MEM_HEADER + count * size);
+    if (!h) return NULL;
+    h->size = count * size; h->tag = tag;
+    Book(tag, (long long)h->size);
+    return (unsigned char*)h + MEM_HEADER;
+}
+
+// Like realloc; the block keeps the tag it was allocated with
+void* TagRealloc(MemTag tag, void* p, size_t size) {
+    if (!p) return TagCalloc(tag, 1, size);
+    BlockHeader* h = (BlockHeader*)((unsigned char*)p - MEM_HEADER);
+    size_t old = h->size;
+    BlockHeader* moved = realloc(h, MEM_HEADER + size);
+    if (!moved) return NULL;
+    moved->size = size;
+    Book((MemTag)moved->tag, -(long long)old); Book((MemTag)moved->tag, (long long)size);
+    return (unsigned char*)moved + MEM_HEADER;
+}
+
+// TagRealloc for arrays that grow together: if it fails, p comes back
+// unchanged (still valid) and *ok is cleared, so the caller can grow the
+// rest and give up once.
+void* TagGrow(MemTag tag, void* p, size_t size, bool* ok) {
+    void* grown = TagRealloc(tag, p, size);
+    if (!grown) { *ok = false; return p; }
+    return grown;
+}
+
+void TagFree(void* p) {
+    if (!p) return;
+    BlockHeader* h = (BlockHeader*)((unsigned char*)p - MEM_HEADER);
+    Book((MemTag)h->tag, -(long long)h->size);
+    free(h);
+}
+
+void TrackStatic(MemTag tag, const char* name, size_t bytes) {
+    int i = 0;
+    while (i < staticCount && strcmp(statics[i].name, name) != 0) i++;
+    if (i == staticCount) { if (staticCount == MEM_MAX_STATICS) return; staticCount++; }
+    else tags[statics[i].tag].staticBytes -= statics[i].bytes;
+    statics[i] = (StaticBlock){ name, tag, bytes };
+    tags[tag].staticBytes += bytes;
+}
+
+// Once per frame: allocations this frame, and bytes per second about once a second
+void MemoryEndFrame() {
+    windowSeconds += GetFrameTime();
+    for (int t = 0; t < MEM_TAG_COUNT; t++) {
+        tags[t].frameAllocs = pendingAllocs[t]; tags[t].frameBytes = pendingBytes[t];
+        windowBytes[t] += pendingBytes[t]; pendingAllocs[t] = 0; pendingBytes[t] = 0;
+    }
+    if (windowSeconds < 1.0f) return;
+    for (int t = 0; t < MEM_TAG_COUNT; t++) { tags[t].bytesPerSecond = windowBytes[t] / windowSeconds; windowBytes[t] = 0; }
+    windowSeconds = 0;
+}
+
+const MemoryStats* GetMemoryStats(MemTag tag) { return &tags[tag]; }
+
+void PrintMemoryReport(FILE* f) {
+    fprintf(f, "\n--- MEMORY REPORT ---\n");
+    fprintf(f, "%-10s %12s %12s %12s %10s\n", "tag", "live", "peak", "static", "allocs");
+    for (int t = 0; t < MEM_TAG_COUNT; t++) {
+        const MemoryStats* s = &tags[t];
+        fprintf(f, "%-10s %12lld %12lld %12zu %10lld\n", MemTagNames[t], s->live, s->peak, s->staticBytes, s->allocs);
+    }
+    for (int i = 0; i < staticCount; i++) fprintf(f, "  static %-20s %-10s %10zu\n", statics[i].name, MemTagNames[statics[i].tag], statics[i].bytes);
+}
@@ -1,32 +1,74 @@
 #include "game.h"
-void InitParticles(ParticleSystem* ps) { for (int i = 0; i < MAX_PARTICLES; i++) ps->particles[i].active = false; }
+#include "rlgl.h"
+
+// --- PARTICLES ---
+// One array per field, and the live particles are always the first count
+// slots. Spawning appends, a dying particle is replaced by the last one, so
+// both are O(1) and every loop stops at count. The update steps four
+// particles at a time with Float4 (count is rounded up to 4; the slots past it
+// are dead and nobody reads them). Rates are per second, scaled from the old
+// per-frame constants at PARTICLE_BASE_FPS, so the effect looks the same at
+// any frame rate. Drawing is one run of rlgl quads.
+
+#define PARTICLE_BASE_FPS 60.0f
+#define PARTICLE_DAMPING 0.95f                        // Velocity kept per 1/60 s
+#define PARTICLE_FADE (0.02f * PARTICLE_BASE_FPS)     // Life lost per second
+#define PARTICLE_SHRINK (0.1f * PARTICLE_BASE_FPS)    // Size lost per second
+#define PARTICLE_MIN_SIZE 0.5f
+#define PARTICLES_PER_EXPLOSION 50
+#define PARTICLE_DRAW_CHUNK 1024                      // Quads per batch check
+
+void InitParticles(ParticleSystem* ps) { ps->count = 0; }
+
 void SpawnExplosion(ParticleSystem* ps, Vector2 position, Color color) {
-    int spawned = 0;
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        if (!ps->particles[i].active) {
-            ps->particles[i].active = true; ps->particles[i].position = position; ps->particles[i].color = color;
-            ps->particles[i].size = (float)GetRandomValue(3, 8); ps->particles[i].life = 1.0f;
-            float speedX = (GetRandomValue(-100, 100) / 10.0f); float speedY = (GetRandomValue(-100, 100) / 10.0f);
-            ps->particles[i].velocity = (Vector2){ speedX * 2.0f, speedY * 2.0f };
-            spawned++; if (spawned >= 50) break;
-        }
+    for (int k = 0; k < PARTICLES_PER_EXPLOSION && ps->count < MAX_PARTICLES; k++) {
+        int i = ps->count++;
+        ps->x[i] = position.x; ps->y[i] = position.y; ps->color[i] = color;
+        ps->size[i] = (float)GetRandomValue(3, 8); ps->life[i] = 1.0f;
+        float speedX = (GetRandomValue(-100, 100) / 10.0f); float speedY = (GetRandomValue(-100, 100) / 10.0f);
+        ps->vx[i] = speedX * 2.0f * PARTICLE_BASE_FPS; ps->vy[i] = speedY * 2.0f * PARTICLE_BASE_FPS; // Pixels per second
     }
 }
-void UpdateParticles(ParticleSystem* ps) {
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        if (ps->particles[i].active) {
-            ps->particles[i].position = Vector2Add(ps->particles[i].position, ps->particles[i].velocity);
-            ps->particles[i].velocity = Vector2Scale(ps->particles[i].velocity, 0.95f);
-            ps->particles[i].life -= 0.02f; if (ps->particles[i].size > 0.5f) ps->particles[i].size -= 0.1f;
-            if (ps->particles[i].life <= 0) ps->particles[i].active = false;
-        }
+
+static Float4 Max4(Float4 a, Float4 b) {
+    Int4 takeA = a > b;
+    return (Float4)((takeA & (Int4)a) | (~takeA & (Int4)b));
+}
+
+void UpdateParticles(ParticleSystem* ps, float dt) {
+    Float4 step = SplatFloat4(dt);
+    Float4 damping = SplatFloat4(powf(PARTICLE_DAMPING, dt * PARTICLE_BASE_FPS));
+    Float4 fade = SplatFloat4(PARTICLE_FADE * dt), shrink = SplatFloat4(PARTICLE_SHRINK * dt);
+    Float4 minSize = SplatFloat4(PARTICLE_MIN_SIZE);
+    for (int i = 0; i < ps->count; i += 4) {
+        Float4 vx = LoadFloat4(&ps->vx[i]), vy = LoadFloat4(&ps->vy[i]);
+        StoreFloat4(&ps->x[i], LoadFloat4(&ps->x[i]) + vx * step);
+        StoreFloat4(&ps->y[i], LoadFloat4(&ps->y[i]) + vy * step);
+        StoreFloat4(&ps->vx[i], vx * damping);
+        StoreFloat4(&ps->vy[i], vy * damping);
+        StoreFloat4(&ps->life[i], LoadFloat4(&ps->life[i]) - fade);
+        StoreFloat4(&ps->size[i], Max4(LoadFloat4(&ps->size[i]) - shrink, minSize));
+    }
+    // Dead ones are replaced by the last live particle
+    for (int i = 0; i < ps->count; ) {
+        if (ps->life[i] > 0) { i++; continue; }
+        int last = --ps->count;
+        ps->x[i] = ps->x[last]; ps->y[i] = ps->y[last]; ps->vx[i] = ps->vx[last]; ps->vy[i] = ps->vy[last];
+        ps->life[i] = ps->life[last]; ps->size[i] = ps->size[last]; ps->color[i] = ps->color[last];
     }
 }
+
 void DrawParticles(ParticleSystem* ps) {
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        if (ps->particles[i].active) {
-            Color c = ps->particles[i].color; c.a = (unsigned char)(255 * ps->particles[i].life);
-            DrawRectangleV(ps->particles[i].position, (Vector2){ps->particles[i].size, ps->particles[i].size}, c);
+    for (int first = 0; first < ps->count; first += PARTICLE_DRAW_CHUNK) {
+        int last = (first + PARTICLE_DRAW_CHUNK < ps->count) ? first + PARTICLE_DRAW_CHUNK : ps->count;
+        rlCheckRenderBatchLimit((last - first) * 4);
+        rlBegin(RL_QUADS);
+        for (int i = first; i < last; i++) {
+            Color c = ps->color[i]; c.a = (unsigned char)(255 * ps->life[i]);
+            float x = ps->x[i], y = ps->y[i], s = ps->size[i];
+            rlColor4ub(c.r, c.g, c.b, c.a);
+            rlVertex2f(x, y); rlVertex2f(x, y + s); rlVertex2f(x + s, y + s); rlVertex2f(x + s, y);
         }
+        rlEnd();
     }
-}
\ No newline at end of file
+}
@@ -3,76 +3,26 @@
 // Returns true if drawn as a Square
 bool IsShapeRect(Entity* e) {
     if (e->state == STATE_STATIC_WALL) return true;
-    if (e->state == STATE_POOL) return true; // Pools are rects
     if (!e->isSpell) return true; 
-    ElementType core = e->spellData.core;
+    ElementType core = e->element;
     // Water is now drawn as rects
     if (core == ELEM_WATER || core == ELEM_EARTH || core == ELEM_FIRE) return true;
-    SpellBehavior b = e->spellData.behavior;
+    SpellBehavior b = e->behavior;
     if (b == SPELL_WALL || b == SPELL_MIDAS || b == SPELL_PHANTOM || b == SPELL_NECROMANCY) return true;
     return false;
 }
 
-// --- FLUID PHYSICS: SPAWN ---
-void SpawnWaterSpread(Entity* parent, Entity* entities, int* count) {
-    int drops = 12; 
-    for(int i=0; i<drops; i++) {
-        if (*count >= MAX_ENTITIES - 1) return; 
-        
-        Entity drop = CreateRawElement(ELEM_WATER, parent->position);
-        drop.size = 6.0f; 
-        drop.mass = 1.0f; 
-        drop.friction = 0.5f; 
-        
-        float angle = (float)GetRandomValue(0, 360) * DEG2RAD;
-        float speed = (float)GetRandomValue(50, 150);
-        
-        drop.velocity = (Vector2){ cosf(angle)*speed, sinf(angle)*speed };
-        drop.lifeTime = 0; 
-        drop.spellData.dryness = 0.0f; 
-        
-        entities[(*count)++] = drop;
-    }
-}
-
-void UpdateEntityAI(Entity* e, Entity* entities, int count, Vector2 targetPos) {
-    if (!e->isActive || !e->isSpell) return;
-    if (e->state == STATE_POOL) return; // Pools have no AI
-
-    if (e->color.r == 255 && e->color.g == 105 && e->color.b == 180) { 
-        e->velocity = (Vector2){ -e->velocity.y, e->velocity.x }; return;
-    }
-
-    if (e->spellData.aiType == AI_HOMING) {
-        Vector2 toTarget = Vector2Subtract(targetPos, e->position);
-        e->velocity = Vector2Add(e->velocity, Vector2Scale(Vector2Normalize(toTarget), 30.0f));
-    }
-}
-
 void UpdateEntityPhysics(Entity* e, Vector2 inputDirection, Rectangle* walls, int wallCount) {
     if (e->isHeld || e->state == STATE_STATIC_WALL) return; 
-    
-    // --- POOL LOGIC ---
-    if (e->state == STATE_POOL) {
-        e->velocity = (Vector2){0,0}; // Freeze position
-        e->lifeTime += GetFrameTime();
-        if (e->lifeTime > 20.0f) { // Evaporate
-            e->size -= 0.01f; 
-            if(e->size <= 0) e->isActive = false;
-        }
-        return; 
-    }
 
     float dt = GetFrameTime(); 
     e->lifeTime += dt * 5.0f;
 
-    // Transition: Moving Water -> Static Pool
-    if (e->state == STATE_RAW && e->spellData.core == ELEM_WATER) {
+    // Transition: Moving Water -> puddle in the fluid grid
+    if (e->state == STATE_RAW && e->element == ELEM_WATER) {
         if (Vector2Length(e->velocity) < 5.0f && e->lifeTime > 1.0f) {
-            e->state = STATE_POOL;
-            e->velocity = (Vector2){0,0};
-            e->position.x = roundf(e->position.x);
-            e->position.y = roundf(e->position.y);
+            DepositWater(e->position, e->size, FLUID_DEPOSIT);
+            e->isActive = false;
             return;
         }
     }
@@ -116,64 +66,170 @@ void UpdateEntityPhysics(Entity* e, Vector2 inputDirection, Rectangle* walls, in
     if (e->position.y > SCREEN_HEIGHT) e->position.y = SCREEN_HEIGHT; 
 }
 
-void ApplySpellFieldEffects(Entity* entities, int count, ParticleSystem* ps) {}
+void ApplySpellFieldEffects(EntityStore* store, ParticleSystem* ps) {}
+
+// --- BROADPHASE (SWEEP AND PRUNE) ---
+// Active entities are kept sorted by the left edge of their box. The order is
+// kept from one frame to the next, so the insertion sort only moves the few
+// that passed a neighbour. Sweeping it gives every pair whose boxes overlap
+// (grown by a margin for the 1 unit pushes made while resolving), and those
+// pairs are resolved in the same i<j order as the old all-pairs loop. The
+// arrays grow with the store; a freed slot just drops out of the order.
+
+#define SWEEP_MARGIN 2.0f
+#define PAIR(i, j) ((unsigned long long)(i) << 32 | (unsigned int)(j))
+
+typedef struct { float minX, maxX, y, size; } SweptBox;
+
+static int sweepCapacity = 0;
+static int* sweepOrder = NULL;
+static int sweepCount = 0;
+static float* sweepMin = NULL;  // Left edge, by entity index
+static bool* sweepSeen = NULL;
+static SweptBox* swept = NULL;  // In sweep order, so the sweep reads memory in order
+static unsigned long long* pairs = NULL;
+static int pairCount = 0, pairCapacity = 0;
+static CollisionStats collisionStats;
+
+static int CompareSweep(const void* a, const void* b) {
+    float ka = sweepMin[*(const int*)a], kb = sweepMin[*(const int*)b];
+    return (ka > kb) - (ka < kb);
+}
+
+static int ComparePairs(const void* a, const void* b) {
+    unsigned long long pa = *(const unsigned long long*)a, pb = *(const unsigned long long*)b;
+    return (pa > pb) - (pa < pb);
+}
+
+static void AddPair(int a, int b) {
+    if (pairCount == pairCapacity) {
+        int capacity = pairCapacity ? pairCapacity * 2 : 1024;
+        unsigned long long* grown = TagRealloc(MEM_ENTITIES, pairs, capacity * sizeof(unsigned long long));
+        if (!grown) return; // Out of memory: this pair is missed for a frame
+        pairs = grown; pairCapacity = capacity;
+    }
+    pairs[pairCount++] = (a < b) ? PAIR(a, b) : PAIR(b, a);
+}
+
+// Last frame's order minus removed entities, plus new ones at the end
+static void UpdateSweepOrder(EntityStore* store) {
+    int count = store->count;
+    if (count > sweepCapacity) {
+        int grown = sweepCapacity ? sweepCapacity : 1024;
+        while (grown < count) grown *= 2;
+        bool ok = true;
+        sweepOrder = TagGrow(MEM_ENTITIES, sweepOrder, grown * sizeof(int), &ok);
+        sweepMin = TagGrow(MEM_ENTITIES, sweepMin, grown * sizeof(float), &ok);
+        sweepSeen = TagGrow(MEM_ENTITIES, sweepSeen, grown * sizeof(bool), &ok);
+        swept = TagGrow(MEM_ENTITIES, swept, grown * sizeof(SweptBox), &ok);
+        if (!ok) { sweepCount = 0; return; } // Out of memory: no collisions this frame, full re-sort next
+        sweepCapacity = grown;
+    }
+    memset(sweepSeen, 0, count * sizeof(bool));
+    int n = 0;
+    for (int k = 0; k < sweepCount; k++) {
+        int i = sweepOrder[k];
+        if (i >= count || !ENTITY(store, i)->isActive || sweepSeen[i]) continue;
+        sweepSeen[i] = true;
+        sweepOrder[n++] = i;
+    }
+    for (int i = 0; i < count; i++) {
+        if (ENTITY(store, i)->isActive && !sweepSeen[i]) sweepOrder[n++] = i;
+    }
+    for (int k = 0; k < n; k++) {
+        Entity* e = ENTITY(store, sweepOrder[k]);
+        sweepMin[sweepOrder[k]] = e->position.x - e->size;
+    }
+    sweepCount = n;
+
+    // Nearly sorted in play. A scene that was rebuilt from scratch falls back to qsort.
+    int shifts = 0;
+    for (int a = 1; a < n; a++) {
+        int i = sweepOrder[a], b = a - 1;
+        float key = sweepMin[i];
+        while (b >= 0 && sweepMin[sweepOrder[b]] > key) { sweepOrder[b + 1] = sweepOrder[b]; b--; shifts++; }
+        sweepOrder[b + 1] = i;
+        if (shifts > 8 * n) { qsort(sweepOrder, n, sizeof(int), CompareSweep); break; }
+    }
+}
 
-void ResolveEntityCollisions(Entity* entities, int* countPtr, Entity* player, ParticleSystem* ps) {
-    int count = *countPtr; 
+// Every pair that might touch, sorted by (i, j)
+static void FindCandidatePairs(EntityStore* store) {
+    UpdateSweepOrder(store);
+    for (int k = 0; k < sweepCount; k++) {
+        Entity* e = ENTITY(store, sweepOrder[k]);
+        swept[k].minX = sweepMin[sweepOrder[k]];
+        swept[k].maxX = e->position.x + e->size + SWEEP_MARGIN;
+        swept[k].y = e->position.y; swept[k].size = e->size + SWEEP_MARGIN * 0.5f;
+    }
+    pairCount = 0;
+    for (int a = 0; a < sweepCount; a++) {
+        for (int b = a + 1; b < sweepCount && swept[b].minX < swept[a].maxX; b++) {
+            if (fabsf(swept[a].y - swept[b].y) >= swept[a].size + swept[b].size) continue;
+            AddPair(sweepOrder[a], sweepOrder[b]);
+        }
+    }
+    qsort(pairs, pairCount, sizeof(unsigned long long), ComparePairs);
+}
+
+const CollisionStats* GetCollisionStats() { return &collisionStats; }
+
+void ResolveEntityCollisions(EntityStore* store, ParticleSystem* ps) {
+    int count = store->count; 
+    FindCandidatePairs(store);
+    collisionStats = (CollisionStats){ .entities = sweepCount, .allPairs = (long long)sweepCount * (sweepCount - 1) / 2 };
     
+    int p = 0;
     for (int i = 0; i < count; i++) {
-        if (!entities[i].isActive) continue;
+        while (p < pairCount && (int)(pairs[p] >> 32) < i) p++; // Pairs of entities that died earlier
+        Entity* a = ENTITY(store, i);
+        if (!a->isActive) continue;
         
-        if (entities[i].state == STATE_PROJECTILE && entities[i].spellData.core == ELEM_WATER) {
-             if (Vector2Length(entities[i].velocity) < 10.0f || entities[i].lifeTime > 10.0f) {
-                 SpawnWaterSpread(&entities[i], entities, countPtr); 
-                 entities[i].isActive = false; continue;
+        if (a->state == STATE_PROJECTILE && a->element == ELEM_WATER) {
+             if (Vector2Length(a->velocity) < 10.0f || a->lifeTime > 10.0f) {
+                 SpawnWaterSpread(a->position); 
+                 a->isActive = false; continue;
              }
         }
 
-        for (int j = i + 1; j < count; j++) {
-            if (!entities[j].isActive) continue;
-            
-            // Interaction: Entity walking on Pool
-            Entity* pool = NULL;
-            Entity* walker = NULL;
-            if(entities[i].state == STATE_POOL && entities[j].state != STATE_POOL) { pool = &entities[i]; walker = &entities[j]; }
-            else if(entities[j].state == STATE_POOL && entities[i].state != STATE_POOL) { pool = &entities[j]; walker = &entities[i]; }
-            
-            if (pool && walker) {
-                if (fabsf(pool->position.x - walker->position.x) < (pool->size + walker->size) &&
-                    fabsf(pool->position.y - walker->position.y) < (pool->size + walker->size)) 
-                {
-                    walker->velocity = Vector2Scale(walker->velocity, 0.95f); // Drag
-                }
-                continue; 
-            }
-            if(entities[i].state == STATE_POOL && entities[j].state == STATE_POOL) continue;
+        // Standing water (see fluid.c): one cell read instead of a pair per puddle
+        float wet = GetWaterCoverage(a->position);
+        if (wet > 0) a->velocity = Vector2Scale(a->velocity, 1.0f - 0.05f * wet); // Drag
+
+        for (; p < pairCount && (int)(pairs[p] >> 32) == i; p++) {
+            int j = (int)(pairs[p] & 0xFFFFFFFFu);
+            Entity* b = ENTITY(store, j);
+            if (!b->isActive) continue;
+            collisionStats.pairsTested++;
 
             // Standard Collision
-            float rI = entities[i].size; 
-            float rJ = entities[j].size;
-            bool collision = (fabsf(entities[i].position.x - entities[j].position.x) * 2 < (rI + rJ) * 2) &&
-                             (fabsf(entities[i].position.y - entities[j].position.y) * 2 < (rI + rJ) * 2);
+            float rI = a->size; 
+            float rJ = b->size;
+            bool collision = (fabsf(a->position.x - b->position.x) * 2 < (rI + rJ) * 2) &&
+                             (fabsf(a->position.y - b->position.y) * 2 < (rI + rJ) * 2);
 
             if (collision) {
-                Entity* proj = (entities[i].state == STATE_PROJECTILE) ? &entities[i] : (entities[j].state == STATE_PROJECTILE ? &entities[j] : NULL);
-                Entity* target = (proj == &entities[i]) ? &entities[j] : &entities[i];
+                collisionStats.overlaps++;
+                Entity* proj = (a->state == STATE_PROJECTILE) ? a : (b->state == STATE_PROJECTILE ? b : NULL);
+                Entity* target = (proj == a) ? b : a;
                 
                 if (proj && target->state != STATE_PROJECTILE) {
-                    if (proj->spellData.core == ELEM_FIRE) { target->color = DARKGRAY; target->health -= 25.0f; SpawnExplosion(ps, target->position, ORANGE); }
-                    if (proj->spellData.core == ELEM_WATER) SpawnWaterSpread(proj, entities, countPtr);
-                    if (proj->spellData.behavior != SPELL_BOUNCE && proj->spellData.behavior != SPELL_CHAIN_LIGHTNING) {
+                    if (proj->element == ELEM_FIRE) {
+                        EntityInfo* info = ENTITY_INFO(store, (target == a) ? i : j);
+                        info->color = DARKGRAY; info->health -= 25.0f; SpawnExplosion(ps, target->position, ORANGE);
+                    }
+                    if (proj->element == ELEM_WATER) SpawnWaterSpread(proj->position);
+                    if (proj->behavior != SPELL_BOUNCE && proj->behavior != SPELL_CHAIN_LIGHTNING) {
                         proj->isActive = false; 
                     }
                     continue;
                 }
 
-                Vector2 diff = Vector2Subtract(entities[i].position, entities[j].position);
+                Vector2 diff = Vector2Subtract(a->position, b->position);
                 if (Vector2Length(diff) == 0) diff = (Vector2){0, -1};
                 Vector2 push = Vector2Scale(Vector2Normalize(diff), 1.0f);
-                entities[i].position = Vector2Add(entities[i].position, push);
-                entities[j].position = Vector2Subtract(entities[j].position, push);
+                a->position = Vector2Add(a->position, push);
+                b->position = Vector2Subtract(b->position, push);
             }
         }
     }
@@ -0,0 +1,183 @@
+#include "game.h"
+
+// --- SPATIAL INDEX ---
+// One index over the entity centres, shared by picking, fusion and steering.
+// main() builds it once per frame, after cleanup, so it stays valid through
+// the draw and the next frame's input. The world is the screen, so the hash
+// is a grid of SPATIAL_CELL squares. Positions off screen go to the border
+// cells. The build is a counting sort: count per cell, prefix sums, scatter.
+// That keeps one flat array with no per-cell limit. A query only visits the
+// cells its shape can reach, grown by the largest entity. Results come back
+// in index order, like the linear scans they replaced. Only active entities
+// are indexed, and the tests read the entities' current state. The entry,
+// result and scratch arrays grow with the store, so nothing caps a query.
+
+#define SPATIAL_CELL 64
+#define SPATIAL_COLS (SCREEN_WIDTH / SPATIAL_CELL + 1)
+#define SPATIAL_ROWS (SCREEN_HEIGHT / SPATIAL_CELL + 1)
+#define SPATIAL_CELLS (SPATIAL_COLS * SPATIAL_ROWS)
+
+static EntityStore* indexed = NULL;
+static int cellStart[SPATIAL_CELLS + 1]; // Entries of cell c: cellEntries[cellStart[c] .. cellStart[c + 1]]
+static int cellFill[SPATIAL_CELLS];
+static int indexedCount = 0;             // Entities in the index
+static float maxSize = 0;                // Largest entity, to grow queries by
+static int capacity = 0;                 // Of the four arrays below
+static int* cellEntries = NULL;
+static Vector2* entryPos = NULL;         // Position of each entry at build time, for GatherRadius
+static int* entityCell = NULL;           // Cell of each slot, -1 = not indexed
+static int* results = NULL;              // Output of the last query
+static float* nearestDist = NULL;        // QueryNearest scratch
+
+static int CellX(float x) { int c = (int)floorf(x / SPATIAL_CELL); return c < 0 ? 0 : (c >= SPATIAL_COLS ? SPATIAL_COLS - 1 : c); }
+static int CellY(float y) { int c = (int)floorf(y / SPATIAL_CELL); return c < 0 ? 0 : (c >= SPATIAL_ROWS ? SPATIAL_ROWS - 1 : c); }
+
+void BuildSpatialIndex(EntityStore* store) {
+    if (!indexed) TrackStatic(MEM_ENTITIES, "spatial index", sizeof(cellStart) + sizeof(cellFill));
+    if (store->count > capacity) {
+        int grown = capacity ? capacity : 1024;
+        while (grown < store->count) grown *= 2;
+        bool ok = true;
+        cellEntries = TagGrow(MEM_ENTITIES, cellEntries, grown * sizeof(int), &ok);
+        entryPos = TagGrow(MEM_ENTITIES, entryPos, grown * sizeof(Vector2), &ok);
+        entityCell = TagGrow(MEM_ENTITIES, entityCell, grown * sizeof(int), &ok);
+        results = TagGrow(MEM_ENTITIES, results, grown * sizeof(int), &ok);
+        nearestDist = TagGrow(MEM_ENTITIES, nearestDist, grown * sizeof(float), &ok);
+        if (!ok) { indexed = NULL; indexedCount = 0; return; } // Out of memory: queries find nothing this frame
+        capacity = grown;
+    }
+    indexed = store;
+    maxSize = 0;
+    memset(cellStart, 0, sizeof(cellStart));
+    // The scatter reuses each entity's cell, so the entities are read only once
+    for (int i = 0; i < store->count; i++) {
+        Entity* e = ENTITY(store, i);
+        int c = -1;
+        if (e->isActive) {
+            c = CellY(e->position.y) * SPATIAL_COLS + CellX(e->position.x);
+            cellStart[c + 1]++;
+            if (e->size > maxSize) maxSize = e->size;
+        }
+        entityCell[i] = c;
+    }
+    for (int c = 0; c < SPATIAL_CELLS; c++) { cellStart[c + 1] += cellStart[c]; cellFill[c] = cellStart[c]; }
+    indexedCount = cellStart[SPATIAL_CELLS];
+    for (int i = 0; i < store->count; i++) { // In index order, so every cell is sorted
+        if (entityCell[i] < 0) continue;
+        int k = cellFill[entityCell[i]]++;
+        cellEntries[k] = i;
+        entryPos[k] = ENTITY(store, i)->position;
+    }
+}
+
+static void SortIndices(int* a, int n) {
+    for (int k = 1; k < n; k++) {
+        int v = a[k], j = k - 1;
+        while (j >= 0 && a[j] > v) { a[j + 1] = a[j]; j--; }
+        a[j + 1] = v;
+    }
+}
+
+typedef enum { SHAPE_POINT, SHAPE_RADIUS, SHAPE_RECT } QueryShape;
+
+static bool Matches(const Entity* e, QueryShape shape, Vector2 p, float r, Rectangle rect) {
+    float dx = e->position.x - p.x, dy = e->position.y - p.y;
+    switch (shape) {
+        case SHAPE_POINT: return dx * dx + dy * dy <= e->size * e->size; // CheckCollisionPointCircle
+        case SHAPE_RADIUS: return sqrtf(dx * dx + dy * dy) < r;
+        default: return e->position.x - e->size < rect.x + rect.width && e->position.x + e->size > rect.x &&
+                        e->position.y - e->size < rect.y + rect.height && e->position.y + e->size > rect.y;
+    }
+}
+
+// Every indexed entity in the cells over [x0, x1] x [y0, y1] that matches the shape
+static int Collect(float x0, float y0, float x1, float y1, QueryShape shape, Vector2 p, float r, Rectangle rect, const int** out) {
+    *out = results;
+    if (!indexed) return 0;
+    int n = 0;
+    int cx0 = CellX(x0), cx1 = CellX(x1), cy0 = CellY(y0), cy1 = CellY(y1);
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            int c = cy * SPATIAL_COLS + cx;
+            for (int k = cellStart[c]; k < cellStart[c + 1]; k++) {
+                if (Matches(ENTITY(indexed, cellEntries[k]), shape, p, r, rect)) results[n++] = cellEntries[k];
+            }
+        }
+    }
+    // Cells are sorted, so a single cell (the common case) is already in order
+    if (cx0 != cx1 || cy0 != cy1) SortIndices(results, n);
+    return n;
+}
+
+// Entities whose circle contains p. Returns how many; *out points at them.
+int QueryPoint(Vector2 p, const int** out) {
+    return Collect(p.x - maxSize, p.y - maxSize, p.x + maxSize, p.y + maxSize, SHAPE_POINT, p, 0, (Rectangle){ 0 }, out);
+}
+
+// Entities whose center is closer than radius to center
+int QueryRadius(Vector2 center, float radius, const int** out) {
+    return Collect(center.x - radius, center.y - radius, center.x + radius, center.y + radius, SHAPE_RADIUS, center, radius, (Rectangle){ 0 }, out);
+}
+
+// Entities whose box (position +- size) overlaps r
+int QueryRect(Rectangle r, const int** out) {
+    return Collect(r.x - maxSize, r.y - maxSize, r.x + r.width + maxSize, r.y + r.height + maxSize, SHAPE_RECT, (Vector2){ 0 }, 0, r, out);
+}
+
+// Like QueryRadius, but into the caller's buffer: at most max entities, in
+// cell order, not sorted. It tests the positions from the build, kept next to
+// the entries, so the scan runs over flat arrays. Hits are then passed to keep
+// (if not NULL), and only the ones it accepts count towards max. It only reads
+// the index, so several threads can run it at once (see steering.c).
+int GatherRadius(Vector2 center, float radius, GatherFilter keep, const void* ctx, int* out, int max) {
+    if (!indexed) return 0;
+    int n = 0;
+    int cx0 = CellX(center.x - radius), cx1 = CellX(center.x + radius), cy0 = CellY(center.y - radius), cy1 = CellY(center.y + radius);
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            int c = cy * SPATIAL_COLS + cx;
+            for (int k = cellStart[c]; k < cellStart[c + 1]; k++) {
+                Vector2 q = entryPos[k];
+                float dx = q.x - center.x, dy = q.y - center.y;
+                if (dx * dx + dy * dy >= radius * radius) continue;
+                if (keep && !keep(cellEntries[k], ctx)) continue;
+                out[n++] = cellEntries[k];
+                if (n == max) return n;
+            }
+        }
+    }
+    return n;
+}
+
+// The k entity centers closest to p, nearest first. Searches rings of cells
+// outwards, and stops once no cell further out can hold anything closer.
+int QueryNearest(Vector2 p, int k, const int** outPtr) {
+    int* out = results;
+    *outPtr = results;
+    if (!indexed || k <= 0) return 0;
+    if (k > indexedCount) k = indexedCount;
+    int n = 0;
+    int px = CellX(p.x), py = CellY(p.y);
+    int maxRing = (SPATIAL_COLS > SPATIAL_ROWS) ? SPATIAL_COLS : SPATIAL_ROWS;
+    for (int ring = 0; ring <= maxRing; ring++) {
+        for (int cy = py - ring; cy <= py + ring; cy++) {
+            if (cy < 0 || cy >= SPATIAL_ROWS) continue;
+            for (int cx = px - ring; cx <= px + ring; cx++) {
+                if (cx < 0 || cx >= SPATIAL_COLS) continue;
+                if (cx != px - ring && cx != px + ring && cy != py - ring && cy != py + ring) continue; // Inside the ring
+                int c = cy * SPATIAL_COLS + cx;
+                for (int e = cellStart[c]; e < cellStart[c + 1]; e++) {
+                    int i = cellEntries[e];
+                    float d = Vector2Distance(p, ENTITY(indexed, i)->position);
+                    if (n == k && d >= nearestDist[n - 1]) continue;
+                    int j = (n < k) ? n++ : n - 1; // Insert in order, dropping the farthest when full
+                    while (j > 0 && nearestDist[j - 1] > d) { nearestDist[j] = nearestDist[j - 1]; out[j] = out[j - 1]; j--; }
+                    nearestDist[j] = d; out[j] = i;
+                }
+            }
+        }
+        // Everything beyond this ring is at least ring cells away
+        if (n == k && nearestDist[n - 1] <= ring * (float)SPATIAL_CELL) break;
+    }
+    return n;
+}
@@ -0,0 +1,133 @@
+#include "game.h"
+#include "rlgl.h"
+
+// --- SPRITE ATLAS ---
+// The shapes the spell visuals are made of (discs, rings, boxes, polygons),
+// drawn once at startup into a RenderTexture at a few sizes. DrawGame turns
+// every chunk into one or more textured quads cut from it: PushSprite queues
+// a quad, FlushSprites hands the queue to rlgl in chunks. The atlas is the
+// only texture, so the queue stays in push order (later entities on top) and
+// rlgl only ends a draw call when its batch buffer is full.
+//
+// Shapes are white (with black details) and take their colour from the tint,
+// so one sprite serves every colour and the translucent ones just use the
+// tint's alpha. Each shape comes in SPRITE_CLASSES radii; a quad uses the
+// smallest one at least as big as itself, so 1 px outlines stay about 1 px.
+
+#define SPRITE_CLASSES 4
+#define SPRITE_PAD 2        // Empty texels around a cell, so bilinear sampling doesn't bleed
+#define SPRITE_DRAW_CHUNK 1024
+
+static const float classRadius[SPRITE_CLASSES] = { 4, 8, 16, 32 };
+static int classY[SPRITE_CLASSES];  // Row of each class in the atlas
+static RenderTexture2D atlas;
+static bool atlasLoaded = false;
+static int atlasW = 0, atlasH = 0;
+
+typedef struct {
+    Vector2 center; float halfW, halfH; float rotation; // Degrees
+    unsigned char shape, sizeClass; Color tint;
+} SpriteQuad;
+
+static SpriteQuad* queue = NULL;
+static int queued = 0, queueCapacity = 0;
+static int lastFlushed = 0;
+
+static int CellSize(int c) { return 2 * ((int)classRadius[c] + SPRITE_PAD); }
+
+static void DrawShape(SpriteShape shape, Vector2 c, float r) {
+    switch (shape) {
+        case SPRITE_SQUARE: DrawRectangleRec((Rectangle){ c.x - r, c.y - r, 2 * r, 2 * r }, WHITE); break;
+        case SPRITE_SQUARE_LINES: DrawRectangleLines(c.x - r, c.y - r, 2 * r, 2 * r, WHITE); break;
+        case SPRITE_DISC: DrawCircleV(c, r, WHITE); break;
+        case SPRITE_RING: DrawCircleLines(c.x, c.y, r, WHITE); break;
+        case SPRITE_HALF_RING: DrawRing(c, r - 2, r, 0, 180, 10, WHITE); break;
+        case SPRITE_TRIANGLE: DrawPoly(c, 3, r, 0, WHITE); break;
+        case SPRITE_HEXAGON: DrawPoly(c, 6, r, 0, WHITE); break;
+        case SPRITE_WEDGE: DrawTriangle((Vector2){ c.x, c.y - r }, (Vector2){ c.x - r, c.y + r }, (Vector2){ c.x + r, c.y + r }, WHITE); break;
+        default: break;
+    }
+}
+
+// Needs the window (it renders into a texture)
+void InitSpriteAtlas() {
+    atlasW = SPRITE_COUNT * CellSize(SPRITE_CLASSES - 1);
+    atlasH = 0;
+    for (int c = SPRITE_CLASSES - 1; c >= 0; c--) { classY[c] = atlasH; atlasH += CellSize(c); }
+    atlas = LoadRenderTexture(atlasW, atlasH);
+    SetTextureFilter(atlas.texture, TEXTURE_FILTER_BILINEAR);
+    BeginTextureMode(atlas);
+    ClearBackground(BLANK);
+    for (int c = 0; c < SPRITE_CLASSES; c++) {
+        for (int s = 0; s < SPRITE_COUNT; s++) {
+            float half = CellSize(c) / 2.0f;
+            DrawShape((SpriteShape)s, (Vector2){ s * CellSize(c) + half, classY[c] + half }, classRadius[c]);
+        }
+    }
+    EndTextureMode();
+    atlasLoaded = true;
+    TrackStatic(MEM_RENDER, "sprite atlas", (size_t)atlasW * atlasH * 4);
+}
+
+void UnloadSpriteAtlas() {
+    if (atlasLoaded) UnloadRenderTexture(atlas);
+    atlasLoaded = false;
+    TagFree(queue);
+    queue = NULL; queued = queueCapacity = 0;
+}
+
+// A shape covering center +- (halfW, halfH) before rotation (degrees, around center)
+void PushSprite(SpriteShape shape, Vector2 center, float halfW, float halfH, float rotation, Color tint) {
+    if (queued == queueCapacity) {
+        int capacity = queueCapacity ? queueCapacity * 2 : 1024;
+        SpriteQuad* grown = TagRealloc(MEM_RENDER, queue, capacity * sizeof(SpriteQuad));
+        if (!grown) return;
+        queue = grown; queueCapacity = capacity;
+    }
+    float r = fmaxf(halfW, halfH);
+    int c = 0;
+    while (c < SPRITE_CLASSES - 1 && classRadius[c] < r) c++;
+    queue[queued++] = (SpriteQuad){ center, halfW, halfH, rotation, (unsigned char)shape, (unsigned char)c, tint };
+}
+
+// A solid line as a stretched square, like DrawLineEx
+void PushLine(Vector2 a, Vector2 b, float thick, Color tint) {
+    Vector2 d = Vector2Subtract(b, a);
+    float angle = atan2f(d.y, d.x) * RAD2DEG;
+    PushSprite(SPRITE_SQUARE, Vector2Lerp(a, b, 0.5f), Vector2Length(d) / 2, thick / 2, angle, tint);
+}
+
+// Draws and empties the queue. Inside BeginMode2D.
+void FlushSprites() {
+    lastFlushed = queued;
+    if (!atlasLoaded || queued == 0) { queued = 0; return; }
+    for (int first = 0; first < queued; first += SPRITE_DRAW_CHUNK) {
+        int last = (first + SPRITE_DRAW_CHUNK < queued) ? first + SPRITE_DRAW_CHUNK : queued;
+        rlCheckRenderBatchLimit((last - first) * 4);
+        rlSetTexture(atlas.texture.id);
+        rlBegin(RL_QUADS);
+        for (int i = first; i < last; i++) {
+            const SpriteQuad* q = &queue[i];
+            float r = classRadius[q->sizeClass], cell = (float)CellSize(q->sizeClass);
+            // The whole cell, so the quad grows by the padding too
+            float grow = (r + SPRITE_PAD) / r;
+            float hw = q->halfW * grow, hh = q->halfH * grow;
+            float cs = cosf(q->rotation * DEG2RAD), sn = sinf(q->rotation * DEG2RAD);
+            float u0 = q->shape * cell / atlasW, u1 = (q->shape + 1) * cell / atlasW;
+            // Render textures are stored upside down
+            float v0 = 1.0f - classY[q->sizeClass] / (float)atlasH, v1 = 1.0f - (classY[q->sizeClass] + cell) / (float)atlasH;
+            rlColor4ub(q->tint.r, q->tint.g, q->tint.b, q->tint.a);
+            const float cornerX[4] = { -hw, -hw, hw, hw }, cornerY[4] = { -hh, hh, hh, -hh };
+            const float cornerU[4] = { u0, u0, u1, u1 }, cornerV[4] = { v0, v1, v1, v0 };
+            for (int k = 0; k < 4; k++) {
+                rlTexCoord2f(cornerU[k], cornerV[k]);
+                rlVertex2f(q->center.x + cornerX[k] * cs - cornerY[k] * sn, q->center.y + cornerX[k] * sn + cornerY[k] * cs);
+            }
+        }
+        rlEnd();
+        rlSetTexture(0);
+    }
+    queued = 0;
+}
+
+int GetSpriteCount() { return lastFlushed; }
@@ -0,0 +1,228 @@
+#define _POSIX_C_SOURCE 200112L // pthreads and sysconf under -std=c99
+#include "game.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <stdint.h>
+
+// --- STEERING ---
+// The AI types RecalculateStats hands out, as steering forces:
+//   HOMING   accelerate straight at the target
+//   PREDICT  accelerate at where the target will be when we get there
+//   ORBIT    circle the target at ORBIT_RADIUS
+//   FLEE     accelerate away while the target is within FLEE_RADIUS
+//   ERRATIC  a new random push every frame
+//   SWARM    separation, alignment and cohesion with nearby swarmers, plus a
+//            weak pull towards the target
+// Forces are capped at STEER_ACCEL (the old homing push of 30 per frame, per
+// second) and the result at the entity's maxSpeed.
+//
+// Every entity reads the state the frame started with (positions, velocities
+// and the spatial index built at the end of last frame) and writes its new
+// velocity into nextVelocity. Nothing is written back until every entity is
+// done, so the order doesn't matter and the work splits into STEER_CHUNK
+// runs of slots. Above STEER_PARALLEL_MIN slots the chunks are shared between
+// the main thread and a pool of workers, started on first use. The workers
+// only read the store and the index and write their own slots of
+// nextVelocity; they never allocate.
+
+#define STEER_ACCEL (30.0f * 60.0f)  // Pixels per second squared
+#define STEER_MAX_LEAD 1.0f          // PREDICT looks at most this far ahead (s)
+#define ORBIT_RADIUS 120.0f
+#define ORBIT_SPEED 300.0f
+#define FLEE_RADIUS 250.0f
+#define SWARM_RADIUS 40.0f
+#define SWARM_NEIGHBOURS 16          // Flockmates used; enough for a stable flock, the rest are ignored
+#define SWARM_ALIGN 2.0f             // Per second: how fast velocities match
+#define SWARM_COHESION 4.0f          // Per second squared, per pixel from the local centre
+#define SWARM_SEEK 0.5f              // Share of STEER_ACCEL spent on the target
+#define STEER_CHUNK 256
+#define STEER_PARALLEL_MIN 1024
+#define STEER_MAX_THREADS 8
+
+static struct {
+    EntityStore* store; Vector2 target, targetVelocity; float dt; unsigned int frame;
+} job;
+
+static Vector2* nextVelocity = NULL;
+static int nextCapacity = 0;
+
+static pthread_t workers[STEER_MAX_THREADS - 1];
+static int threadCount = 0;           // Including the main thread, 0 = pool not started
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t poolWake = PTHREAD_COND_INITIALIZER, poolDone = PTHREAD_COND_INITIALIZER;
+static unsigned int poolGeneration = 0; // Bumped for every job
+static unsigned int poolStart = 0;      // poolGeneration when the workers were started
+static int poolBusy = 0;                // Workers still on the current job
+static bool poolQuit = false;
+
+static Vector2 ClampLength(Vector2 v, float max) {
+    float len = Vector2Length(v);
+    return (len > max && len > 0) ? Vector2Scale(v, max / len) : v;
+}
+
+// Integer hash of (slot, frame) to an angle: rand() is not thread-safe
+static float ErraticAngle(int index, unsigned int frame) {
+    unsigned int h = (unsigned int)index * 0x9E3779B1u ^ frame * 0x85EBCA77u;
+    h ^= h >> 15; h *= 0x2C1B3C6Du; h ^= h >> 12;
+    return (h & 0xFFFF) * (2 * PI / 65536.0f);
+}
+
+typedef struct { EntityStore* store; int self; } Flockmates;
+
+// Other active swarmers only, so the neighbour cap is spent on the flock
+static bool IsFlockmate(int index, const void* ctx) {
+    const Flockmates* f = ctx;
+    if (index == f->self) return false;
+    const Entity* o = ENTITY(f->store, index);
+    return o->isActive && o->ai == AI_SWARM;
+}
+
+static Vector2 SwarmForce(EntityStore* store, int index, const Entity* e) {
+    int near[SWARM_NEIGHBOURS];
+    Flockmates mates = { store, index };
+    int n = GatherRadius(e->position, SWARM_RADIUS, IsFlockmate, &mates, near, SWARM_NEIGHBOURS);
+    Vector2 separation = { 0 }, velocity = { 0 }, centre = { 0 };
+    int flock = 0;
+    for (int k = 0; k < n; k++) {
+        const Entity* o = ENTITY(store, near[k]);
+        Vector2 away = Vector2Subtract(e->position, o->position);
+        float d = Vector2Length(away);
+        if (d > 0) separation = Vector2Add(separation, Vector2Scale(away, (1.0f - d / SWARM_RADIUS) / d));
+        velocity = Vector2Add(velocity, o->velocity);
+        centre = Vector2Add(centre, o->position);
+        flock++;
+    }
+    Vector2 force = Vector2Scale(Vector2Normalize(Vector2Subtract(job.target, e->position)), STEER_ACCEL * SWARM_SEEK);
+    if (flock == 0) return force;
+    force = Vector2Add(force, Vector2Scale(ClampLength(separation, 1.0f), STEER_ACCEL));
+    force = Vector2Add(force, Vector2Scale(Vector2Subtract(Vector2Scale(velocity, 1.0f / flock), e->velocity), SWARM_ALIGN));
+    force = Vector2Add(force, Vector2Scale(Vector2Subtract(Vector2Scale(centre, 1.0f / flock), e->position), SWARM_COHESION));
+    return force;
+}
+
+// The new velocity of one entity, from the frame's starting state
+static Vector2 Steer(EntityStore* store, int index) {
+    const Entity* e = ENTITY(store, index);
+    if (!e->isActive || !e->isSpell) return e->velocity;
+
+    Color c = ENTITY_INFO(store, index)->color;
+    if (c.r == 255 && c.g == 105 && c.b == 180) return (Vector2){ -e->velocity.y, e->velocity.x };
+
+    Vector2 toTarget = Vector2Subtract(job.target, e->position);
+    float dist = Vector2Length(toTarget);
+    Vector2 force = { 0 };
+    switch (e->ai) {
+        case AI_HOMING:
+            force = Vector2Scale(Vector2Normalize(toTarget), STEER_ACCEL);
+            break;
+        case AI_PREDICT: {
+            float speed = fmaxf(Vector2Length(e->velocity), 1.0f);
+            float lead = fminf(dist / speed, STEER_MAX_LEAD);
+            Vector2 aim = Vector2Add(job.target, Vector2Scale(job.targetVelocity, lead));
+            force = Vector2Scale(Vector2Normalize(Vector2Subtract(aim, e->position)), STEER_ACCEL);
+            break;
+        }
+        case AI_ORBIT: {
+            if (dist <= 0) break;
+            Vector2 in = Vector2Scale(toTarget, 1.0f / dist);
+            Vector2 desired = Vector2Add(Vector2Scale((Vector2){ -in.y, in.x }, ORBIT_SPEED), Vector2Scale(in, dist - ORBIT_RADIUS));
+            force = Vector2Scale(Vector2Subtract(desired, e->velocity), 1.0f / job.dt); // As fast as STEER_ACCEL allows
+            break;
+        }
+        case AI_FLEE:
+            if (dist < FLEE_RADIUS) force = Vector2Scale(Vector2Normalize(toTarget), -STEER_ACCEL);
+            break;
+        case AI_ERRATIC: {
+            float a = ErraticAngle(index, job.frame);
+            force = (Vector2){ cosf(a) * STEER_ACCEL, sinf(a) * STEER_ACCEL };
+            break;
+        }
+        case AI_SWARM:
+            force = SwarmForce(store, index, e);
+            break;
+        default:
+            return e->velocity;
+    }
+    Vector2 v = Vector2Add(e->velocity, Vector2Scale(ClampLength(force, STEER_ACCEL), job.dt));
+    // Homing kept the old unbounded push; the others stay under maxSpeed
+    return (e->ai == AI_HOMING || e->maxSpeed <= 0) ? v : ClampLength(v, e->maxSpeed);
+}
+
+// Chunks worker, worker + threads, ... of slots 1..count (0 is the player)
+static void RunChunks(int worker, int threads) {
+    int count = job.store->count;
+    for (int first = 1 + worker * STEER_CHUNK; first < count; first += threads * STEER_CHUNK) {
+        int last = (first + STEER_CHUNK < count) ? first + STEER_CHUNK : count;
+        for (int i = first; i < last; i++) nextVelocity[i] = Steer(job.store, i);
+    }
+}
+
+static void* SteerWorker(void* arg) {
+    int worker = (int)(intptr_t)arg;
+    unsigned int seen = poolStart;
+    for (;;) {
+        pthread_mutex_lock(&poolLock);
+        while (poolGeneration == seen && !poolQuit) pthread_cond_wait(&poolWake, &poolLock);
+        bool quit = poolQuit;
+        seen = poolGeneration;
+        pthread_mutex_unlock(&poolLock);
+        if (quit) return NULL;
+        RunChunks(worker, threadCount);
+        pthread_mutex_lock(&poolLock);
+        if (--poolBusy == 0) pthread_cond_signal(&poolDone);
+        pthread_mutex_unlock(&poolLock);
+    }
+}
+
+static void StartPool() {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    poolStart = poolGeneration;
+    threadCount = (cores < 1) ? 1 : (cores > STEER_MAX_THREADS ? STEER_MAX_THREADS : (int)cores);
+    for (int w = 1; w < threadCount; w++) {
+        if (pthread_create(&workers[w - 1], NULL, SteerWorker, (void*)(intptr_t)w) != 0) { threadCount = w; break; }
+    }
+}
+
+void ShutdownSteering() {
+    pthread_mutex_lock(&poolLock);
+    poolQuit = true;
+    pthread_cond_broadcast(&poolWake);
+    pthread_mutex_unlock(&poolLock);
+    for (int w = 1; w < threadCount; w++) pthread_join(workers[w - 1], NULL);
+    threadCount = 0;
+    poolQuit = false;
+    TagFree(nextVelocity);
+    nextVelocity = NULL; nextCapacity = 0;
+}
+
+// Call before the physics step, with the spatial index from the end of last frame
+void UpdateSteering(EntityStore* store, Vector2 targetPos, Vector2 targetVelocity, float dt) {
+    if (store->count <= 1 || dt <= 0) return;
+    if (store->count > nextCapacity) {
+        int capacity = nextCapacity ? nextCapacity : 1024;
+        while (capacity < store->count) capacity *= 2;
+        Vector2* grown = TagRealloc(MEM_ENTITIES, nextVelocity, capacity * sizeof(Vector2));
+        if (!grown) return;
+        nextVelocity = grown; nextCapacity = capacity;
+    }
+    job.store = store; job.target = targetPos; job.targetVelocity = targetVelocity; job.dt = dt; job.frame++;
+
+    if (store->count < STEER_PARALLEL_MIN) {
+        RunChunks(0, 1);
+    } else {
+        if (threadCount == 0) StartPool();
+        pthread_mutex_lock(&poolLock);
+        poolBusy = threadCount - 1;
+        poolGeneration++;
+        pthread_cond_broadcast(&poolWake);
+        pthread_mutex_unlock(&poolLock);
+        RunChunks(0, threadCount);
+        pthread_mutex_lock(&poolLock);
+        while (poolBusy > 0) pthread_cond_wait(&poolDone, &poolLock);
+        pthread_mutex_unlock(&poolLock);
+    }
+    for (int i = 1; i < store->count; i++) {
+        Entity* e = ENTITY(store, i);
+        if (e->isActive) e->velocity = nextVelocity[i];
+    }
+}
@@ -6,43 +6,56 @@
 const char* ElementNames[] = { "None", "Earth", "Water", "Fire", "Air" };
 
 typedef struct {
-    char name[32]; char desc[64]; Color col; ElementType core; char recipe[32]; char activation[32];
+    char name[32]; char desc[64]; Color col; char activation[32];
+    ElementType core; char recipe[48]; // From the fusion table (GetFusionRecipe)
 } SpellInfo;
 
-SpellInfo GetSpellInfo(SpellBehavior b) {
+static SpellInfo DescribeSpell(SpellBehavior b) {
     switch(b) {
-        case SPELL_WALL: return (SpellInfo){"Wall Creator", "Blocks movement.", ORANGE, ELEM_EARTH, "Aux: 1 Earth", "On Impact"};
-        case SPELL_PETRIFY: return (SpellInfo){"Petrification", "Turns foes to stone.", DARKGRAY, ELEM_EARTH, "Aux: 2 Earth", "On Impact"};
-        case SPELL_GROWTH: return (SpellInfo){"Growth Ray", "Enlarges targets.", GREEN, ELEM_EARTH, "Aux: 2 Water", "On Impact"};
-        case SPELL_LANDMINE: return (SpellInfo){"Landmine", "Invisible trap.", GRAY, ELEM_EARTH, "Aux: 1 Fire", "On Contact"};
-        case SPELL_REWIND: return (SpellInfo){"Time Rewind", "Resets positions.", GOLD, ELEM_EARTH, "Aux: 1 Water+1 Air", "On Impact"};
-        case SPELL_MAGNET: return (SpellInfo){"Magnetism", "Attracts Earth.", GRAY, ELEM_EARTH, "Aux: 1 Air+1 Fire", "Passive Field"};
-        case SPELL_MIDAS: return (SpellInfo){"Midas Touch", "Turns targets to gold.", GOLD, ELEM_FIRE, "Aux: 1 Earth", "On Impact"};
-        case SPELL_BERSERK: return (SpellInfo){"Berserker", "Wild speed boost.", MAROON, ELEM_FIRE, "Aux: 2 Fire", "Self/Buff"};
-        case SPELL_CLUSTER: return (SpellInfo){"Cluster Bomb", "Explosive shards.", ORANGE, ELEM_FIRE, "Aux: 1 Fire+1 Earth", "On Impact"};
-        case SPELL_VOID: return (SpellInfo){"Void Well", "Black hole suction.", MAGENTA, ELEM_FIRE, "Aux: 2 Air", "Passive Field"};
-        case SPELL_CHAIN_LIGHTNING: return (SpellInfo){"Chain Lightning", "Arcs damage.", YELLOW, ELEM_FIRE, "Aux: 1 Air", "On Impact"};
-        case SPELL_CONFUSE: return (SpellInfo){"Confuse Ray", "Reverses controls.", PINK, ELEM_FIRE, "Aux: 1 Water+1 Air", "On Impact"};
-        case SPELL_SHRINK: return (SpellInfo){"Shrink Ray", "Shrinks targets.", PURPLE, ELEM_FIRE, "Aux: 1 Air", "On Impact"};
-        case SPELL_TSUNAMI: return (SpellInfo){"Tsunami", "Massive wave push.", BLUE, ELEM_WATER, "Aux: 2 Water", "Passive Wave"};
-        case SPELL_FREEZE: return (SpellInfo){"Permafrost", "Freezes targets.", SKYBLUE, ELEM_WATER, "Aux: 1 Air", "On Impact"};
-        case SPELL_VAMPIRISM: return (SpellInfo){"Blood Siphon", "Steals life.", RED, ELEM_WATER, "Aux: 1 Fire+1 Earth", "On Impact"};
-        case SPELL_BOUNCE: return (SpellInfo){"Bouncer", "Bounces off walls.", ORANGE, ELEM_WATER, "Aux: 1 Earth", "Passive"};
-        case SPELL_SWARM: return (SpellInfo){"Insect Swarm", "Homing swarm.", BROWN, ELEM_WATER, "Aux: 1 Air+1 Earth", "AI Controlled"};
-        case SPELL_POISON: return (SpellInfo){"Toxic Cloud", "Poison area.", LIME, ELEM_WATER, "Aux: 1 Earth+1 Fire", "On Impact"};
-        case SPELL_MIRROR: return (SpellInfo){"Doppelganger", "Clone self.", SKYBLUE, ELEM_WATER, "Aux: 1 Air+1 Fire", "On Cast"};
-        case SPELL_HEAL: return (SpellInfo){"Healing Orb", "Restores health.", GREEN, ELEM_WATER, "Aux: Any", "On Contact"};
-        case SPELL_WHIRLWIND: return (SpellInfo){"Whirlwind", "Pushes away.", LIGHTGRAY, ELEM_AIR, "Aux: 2 Air", "Passive Field"};
-        case SPELL_TELEKINESIS: return (SpellInfo){"Gravity Well", "Crushing gravity.", LIGHTGRAY, ELEM_AIR, "Aux: 1 Air", "Passive Field"};
-        case SPELL_PHANTOM: return (SpellInfo){"Phase Shift", "Passes walls.", PURPLE, ELEM_AIR, "Aux: 1 Water", "Passive"};
-        case SPELL_SNIPER: return (SpellInfo){"Railgun", "Fast straight shot.", RED, ELEM_AIR, "Aux: 1 Fire+1 Earth", "Projectile"};
-        case SPELL_SLOW: return (SpellInfo){"Mud Trap", "Slows enemies.", BROWN, ELEM_EARTH, "Aux: 1 Water", "On Impact"};
-        case SPELL_NECROMANCY: return (SpellInfo){"Necromancy", "Raises objects.", DARKGRAY, ELEM_EARTH, "Aux: 1 Water+1 Air", "On Impact"};
-        default: return (SpellInfo){"Unknown", "???", GRAY, ELEM_NONE, "", ""};
+        case SPELL_WALL: return (SpellInfo){"Wall Creator", "Blocks movement.", ORANGE, "On Impact"};
+        case SPELL_PETRIFY: return (SpellInfo){"Petrification", "Turns foes to stone.", DARKGRAY, "On Impact"};
+        case SPELL_GROWTH: return (SpellInfo){"Growth Ray", "Enlarges targets.", GREEN, "On Impact"};
+        case SPELL_LANDMINE: return (SpellInfo){"Landmine", "Invisible trap.", GRAY, "On Contact"};
+        case SPELL_REWIND: return (SpellInfo){"Time Rewind", "Resets positions.", GOLD, "On Impact"};
+        case SPELL_MAGNET: return (SpellInfo){"Magnetism", "Attracts Earth.", GRAY, "Passive Field"};
+        case SPELL_MIDAS: return (SpellInfo){"Midas Touch", "Turns targets to gold.", GOLD, "On Impact"};
+        case SPELL_BERSERK: return (SpellInfo){"Berserker", "Wild speed boost.", MAROON, "Self/Buff"};
+        case SPELL_CLUSTER: return (SpellInfo){"Cluster Bomb", "Explosive shards.", ORANGE, "On Impact"};
+        case SPELL_VOID: return (SpellInfo){"Void Well", "Black hole suction.", MAGENTA, "Passive Field"};
+        case SPELL_CHAIN_LIGHTNING: return (SpellInfo){"Chain Lightning", "Arcs damage.", YELLOW, "On Impact"};
+        case SPELL_CONFUSE: return (SpellInfo){"Confuse Ray", "Reverses controls.", PINK, "On Impact"};
+        case SPELL_SHRINK: return (SpellInfo){"Shrink Ray", "Shrinks targets.", PURPLE, "On Impact"};
+        case SPELL_TSUNAMI: return (SpellInfo){"Tsunami", "Massive wave push.", BLUE, "Passive Wave"};
+        case SPELL_FREEZE: return (SpellInfo){"Permafrost", "Freezes targets.", SKYBLUE, "On Impact"};
+        case SPELL_VAMPIRISM: return (SpellInfo){"Blood Siphon", "Steals life.", RED, "On Impact"};
+        case SPELL_BOUNCE: return (SpellInfo){"Bouncer", "Bounces off walls.", ORANGE, "Passive"};
+        case SPELL_SWARM: return (SpellInfo){"Insect Swarm", "Homing swarm.", BROWN, "AI Controlled"};
+        case SPELL_POISON: return (SpellInfo){"Toxic Cloud", "Poison area.", LIME, "On Impact"};
+        case SPELL_MIRROR: return (SpellInfo){"Doppelganger", "Clone self.", SKYBLUE, "On Cast"};
+        case SPELL_HEAL: return (SpellInfo){"Healing Orb", "Restores health.", GREEN, "On Contact"};
+        case SPELL_WHIRLWIND: return (SpellInfo){"Whirlwind", "Pushes away.", LIGHTGRAY, "Passive Field"};
+        case SPELL_TELEKINESIS: return (SpellInfo){"Gravity Well", "Crushing gravity.", LIGHTGRAY, "Passive Field"};
+        case SPELL_PHANTOM: return (SpellInfo){"Phase Shift", "Passes walls.", PURPLE, "Passive"};
+        case SPELL_SNIPER: return (SpellInfo){"Railgun", "Fast straight shot.", RED, "Projectile"};
+        case SPELL_SLOW: return (SpellInfo){"Mud Trap", "Slows enemies.", BROWN, "On Impact"};
+        case SPELL_NECROMANCY: return (SpellInfo){"Necromancy", "Raises objects.", DARKGRAY, "On Impact"};
+        default: return (SpellInfo){"Unknown", "???", GRAY, ""};
+    }
+}
+
+SpellInfo GetSpellInfo(SpellBehavior b) {
+    SpellInfo info = DescribeSpell(b);
+    int count[5];
+    if (!GetFusionRecipe(b, &info.core, count)) { snprintf(info.recipe, sizeof(info.recipe), "Not craftable"); return info; }
+    int len = snprintf(info.recipe, sizeof(info.recipe), "Aux:");
+    for (int el = ELEM_EARTH; el <= ELEM_AIR; el++) {
+        if (count[el] == 0) continue;
+        len += snprintf(info.recipe + len, sizeof(info.recipe) - len, "%s%d %s", (len > 4) ? "+" : " ", count[el], ElementNames[el]);
     }
+    return info;
 }
 
-void DrawHUD(Entity* player, Player* stats) {
+void DrawHUD(EntityInfo* player, Player* stats) {
     DrawRectangle(10, 10, 200, 20, DARKGRAY);
     if (player->maxHealth > 0) DrawRectangle(10, 10, (int)(200 * (player->health/player->maxHealth)), 20, RED);
     DrawRectangleLines(10, 10, 200, 20, BLACK);
@@ -51,7 +64,7 @@ void DrawHUD(Entity* player, Player* stats) {
     DrawRectangle(10, 40, 200, 20, DARKGRAY);
     DrawText(TextFormat("MANA: %.0f", stats->mana), 10, 40, 20, BLUE);
     
-    DrawText("Press [C] for Compendium | [F1] Unlock All", 10, 70, 10, BLACK);
+    DrawText("Press [C] for Compendium | [F1] Unlock All | [F3] Memory", 10, 70, 10, BLACK);
     
     if (stats->book.notificationTimer > 0) {
         stats->book.notificationTimer -= GetFrameTime();
@@ -104,32 +117,33 @@ void DrawCompendium(Player* player) {
     DrawRectangle(SCREEN_WIDTH - 10, headerHeight + (scrollPercent * (viewHeight - 50)), 5, 50, LIGHTGRAY);
 }
 
-void DrawEntityTooltip(Entity* e, int x, int y) {
+void DrawEntityTooltip(Entity* e, EntityInfo* info, int x, int y) {
+    Spell* s = &info->spellData;
     int width = 230; int height = 200; 
     DrawRectangle(x + 20, y - 20, width, height, Fade(BLACK, 0.9f));
     DrawRectangleLines(x + 20, y - 20, width, height, WHITE);
     int tx = x+30; int ty = y-10;
     if (e->state == STATE_RAW) {
         DrawText("Raw Element", tx, ty, 10, LIGHTGRAY);
-        DrawText(TextFormat("Core: %s", ElementNames[e->spellData.core]), tx, ty+20, 10, GetElementColor(e->spellData.core));
+        DrawText(TextFormat("Core: %s", ElementNames[s->core]), tx, ty+20, 10, GetElementColor(s->core));
         DrawText("Right Click to Fuse", tx, ty+40, 10, YELLOW);
     } 
     else if (e->state == STATE_PROJECTILE) {
-        DrawText(e->spellData.name, tx, ty, 10, YELLOW);
-        DrawText(TextFormat("Core: %s", ElementNames[e->spellData.core]), tx, ty+20, 10, GetElementColor(e->spellData.core));
-        DrawText(TextFormat("Aux: %d", e->spellData.auxCount), tx, ty+35, 10, GRAY);
-        if(e->spellData.behavior != SPELL_PROJECTILE) {
-             SpellInfo info = GetSpellInfo(e->spellData.behavior); 
-             DrawText(TextFormat("[!] %s", info.name), tx, ty+55, 10, info.col);
+        DrawText(s->name, tx, ty, 10, YELLOW);
+        DrawText(TextFormat("Core: %s", ElementNames[s->core]), tx, ty+20, 10, GetElementColor(s->core));
+        DrawText(TextFormat("Aux: %d", s->auxCount), tx, ty+35, 10, GRAY);
+        if(s->behavior != SPELL_PROJECTILE) {
+             SpellInfo spell = GetSpellInfo(s->behavior); 
+             DrawText(TextFormat("[!] %s", spell.name), tx, ty+55, 10, spell.col);
         }
-        if(e->spellData.isTeleport) {
+        if(s->isTeleport) {
              DrawText("[!] Teleport Enabled", tx, ty+70, 10, PURPLE); DrawText("(Press T)", tx, ty+85, 10, LIGHTGRAY);
         }
-        else if(e->spellData.aiType != AI_LINEAR) {
+        else if(s->aiType != AI_LINEAR) {
             DrawText("[AI] Smart Movement", tx, ty+70, 10, WHITE);
         }
         ty += 40;
-        DrawText(TextFormat("Temp: %.1f C", e->spellData.temperature), tx, ty+60, 10, (e->spellData.temperature>50)?RED:BLUE);
+        DrawText(TextFormat("Temp: %.1f C", s->temperature), tx, ty+60, 10, (s->temperature>50)?RED:BLUE);
     }
 }
 
@@ -157,7 +171,23 @@ void DrawInventory(Inventory* inv, int x, int y) {
         bool isSelected = (inv->selectedSlot == i);
         DrawRectangleRec(slot, Fade(LIGHTGRAY, 0.5f));
         DrawRectangleLinesEx(slot, isSelected ? 3 : 2, isSelected ? GREEN : DARKGRAY);
-        if (i < inv->count) { DrawRectangle(slot.x + 10, slot.y + 10, 20, 20, inv->items[i].color); }
+        if (i < inv->count) { DrawRectangle(slot.x + 10, slot.y + 10, 20, 20, inv->items[i].cold.color); }
         DrawText(TextFormat("%d", i+1), slot.x + 2, slot.y + 2, 10, GRAY);
     }
-}
\ No newline at end of file
+}
+
+// Per tag: live, peak and static bytes, allocations this frame (orange = churn)
+void DrawMemoryPanel() {
+    int x = 10, y = 90;
+    DrawRectangle(x - 5, y - 5, 330, 65 + 15 * MEM_TAG_COUNT, Fade(BLACK, 0.7f));
+    DrawText("Tag        Live KB   Peak KB   Static KB   Allocs/f", x, y, 10, LIGHTGRAY);
+    for (int t = 0; t < MEM_TAG_COUNT; t++) {
+        const MemoryStats* s = GetMemoryStats((MemTag)t);
+        Color c = (s->frameAllocs > 0) ? ORANGE : WHITE;
+        DrawText(TextFormat("%-10s %7.1f   %7.1f   %9.1f   %d", MemTagNames[t], s->live / 1024.0, s->peak / 1024.0, s->staticBytes / 1024.0, s->frameAllocs), x, y + 15 * (t + 1), 10, c);
+    }
+    const CollisionStats* cs = GetCollisionStats();
+    DrawText(TextFormat("Collisions: %d entities, %d/%lld pairs tested, %d overlaps", cs->entities, cs->pairsTested, cs->allPairs, cs->overlaps), x, y + 15 * (MEM_TAG_COUNT + 1), 10, SKYBLUE);
+    DrawText(TextFormat("Water: %d wet cells", GetWetCellCount()), x, y + 15 * (MEM_TAG_COUNT + 2), 10, SKYBLUE);
+    DrawText(TextFormat("Sprites: %d quads", GetSpriteCount()), x, y + 15 * (MEM_TAG_COUNT + 3), 10, SKYBLUE);
+}
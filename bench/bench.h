@@ -0,0 +1,149 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// --- MICROBENCHMARK HARNESS ---
+// Shared by bench/bench_world.c and "NEWRPG (v2.1)/bench/bench_legacy.c".
+// Include once per benchmark program, after defining _POSIX_C_SOURCE.
+//
+// Each benchmark is a setup step (not timed) and a run step (timed) that does
+// `ops` operations. We take samples until BENCH_MIN_SECONDS have passed and
+// report the median ns per op, which is steadier than the mean on a busy
+// desktop.
+//
+// Results are written as JSON, one result per line, so the baseline compare
+// below can read them back without a JSON library:
+//   {"suite": "world", "results": [
+//     {"name": "GetDensity", "ns_per_op": 1.25, "samples": 120},
+//     ...
+//   ]}
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_RESULTS 64
+#define BENCH_MAX_SAMPLES 256
+#define BENCH_MIN_SAMPLES 5
+#define BENCH_MIN_SECONDS 0.25
+
+typedef struct {
+    char name[64];
+    double nsPerOp;
+    int samples;
+} BenchResult;
+
+static BenchResult benchResults[BENCH_MAX_RESULTS];
+static int benchCount = 0;
+static volatile long benchSink; // Keeps results "used" so the compiler can't drop the work
+
+static double BenchNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int BenchCompare(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// The stored result, or NULL if the table was already full
+static const BenchResult* BenchRun(const char* name, void (*setup)(void*), void (*run)(void*), void* ctx, int ops) {
+    static double samples[BENCH_MAX_SAMPLES];
+    int count = 0;
+    double spent = 0;
+
+    while (count < BENCH_MAX_SAMPLES && (count < BENCH_MIN_SAMPLES || spent < BENCH_MIN_SECONDS * 1e9)) {
+        if (setup) setup(ctx);
+        double start = BenchNow();
+        run(ctx);
+        double elapsed = BenchNow() - start;
+        samples[count++] = elapsed / ops;
+        spent += elapsed;
+    }
+    qsort(samples, count, sizeof(double), BenchCompare);
+
+    if (benchCount >= BENCH_MAX_RESULTS) return NULL;
+    BenchResult* r = &benchResults[benchCount++];
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->nsPerOp = samples[count / 2];
+    r->samples = count;
+    printf("%-36s %12.1f ns/op  (%d samples)\n", r->name, r->nsPerOp, r->samples);
+    return r;
+}
+
+static bool BenchWriteJson(const char* path, const char* suite) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "{\"suite\": \"%s\", \"results\": [\n", suite);
+    for (int i = 0; i < benchCount; i++) {
+        fprintf(f, "  {\"name\": \"%s\", \"ns_per_op\": %.3f, \"samples\": %d}%s\n",
+                benchResults[i].name, benchResults[i].nsPerOp, benchResults[i].samples, (i + 1 < benchCount) ? "," : "");
+    }
+    fprintf(f, "]}\n");
+    fclose(f);
+    return true;
+}
+
+// Returns the number of benchmarks slower than baseline * (1 + threshold%).
+// A missing baseline is not an error: it is recorded from this run instead.
+static int BenchCompareBaseline(const char* path, const char* suite, double thresholdPercent) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        printf("No baseline at %s, recording this run as the baseline.\n", path);
+        BenchWriteJson(path, suite);
+        return 0;
+    }
+
+    int regressions = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char name[64];
+        double baseNs;
+        char* p = strstr(line, "\"name\": \"");
+        char* q = strstr(line, "\"ns_per_op\": ");
+        if (!p || !q) continue;
+        if (sscanf(p + 9, "%63[^\"]", name) != 1 || sscanf(q + 13, "%lf", &baseNs) != 1) continue;
+
+        for (int i = 0; i < benchCount; i++) {
+            if (strcmp(benchResults[i].name, name) != 0) continue;
+            double change = (baseNs > 0) ? (benchResults[i].nsPerOp / baseNs - 1.0) * 100.0 : 0.0;
+            bool slower = change > thresholdPercent;
+            if (slower) regressions++;
+            printf("%-36s %+7.1f%%%s\n", name, change, slower ? "  REGRESSION" : "");
+        }
+    }
+    fclose(f);
+    return regressions;
+}
+
+// Common command line: [--out file] [--baseline file] [--threshold percent] [--update-baseline]
+// Returns the process exit code (1 if anything regressed).
+static int BenchFinish(int argc, char** argv, const char* suite) {
+    const char* out = NULL;
+    const char* baseline = NULL;
+    double threshold = 10.0;
+    bool update = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) out = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baseline = argv[++i];
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) threshold = atof(argv[++i]);
+        else if (strcmp(argv[i], "--update-baseline") == 0) update = true;
+    }
+
+    if (out && !BenchWriteJson(out, suite)) printf("Could not write %s\n", out);
+    if (!baseline) return 0;
+    if (update) {
+        BenchWriteJson(baseline, suite);
+        printf("Baseline updated: %s\n", baseline);
+        return 0;
+    }
+
+    int regressions = BenchCompareBaseline(baseline, suite, threshold);
+    if (regressions > 0) printf("%d benchmark(s) regressed by more than %.0f%%\n", regressions, threshold);
+    return regressions > 0 ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,146 @@
+#define _POSIX_C_SOURCE 200112L // clock_gettime under -std=c99
+#include "../game.h"
+#include "bench.h"
+
+// --- WORLD BENCHMARKS ---
+// Hot paths of the cell world: the per-cell helpers, player collision,
+// the brush, pathfinding queries, and whole UpdateWorld ticks on a few
+// typical grids, and batches of headless worlds on the thread pool.
+
+#define HELPER_OPS 1000000
+#define COLLISION_OPS 100000
+#define EDIT_OPS 1000
+#define PATH_OPS 200
+#define FLOW_OPS 100000
+#define TICK_OPS 30
+#define BATCH_WORLDS 64
+#define BATCH_TICKS 10
+
+// --- HELPERS ---
+
+static void RunGetDensity(void* ctx) {
+    long sum = 0;
+    for (int i = 0; i < HELPER_OPS; i++) sum += GetDensity((BlockType)(i % BLOCK_COUNT));
+    benchSink = sum;
+}
+
+static void RunIsSolid(void* ctx) {
+    long sum = 0;
+    for (int i = 0; i < HELPER_OPS; i++) sum += IsSolid((BlockType)(i % BLOCK_COUNT));
+    benchSink = sum;
+}
+
+static void RunCheckCollision(void* ctx) {
+    long hits = 0;
+    for (int i = 0; i < COLLISION_OPS; i++) {
+        Vector2 pos = { (float)((i * 37) % SCREEN_WIDTH), (float)((i * 53) % SCREEN_HEIGHT) };
+        hits += CheckCollision(pos, 12.0f);
+    }
+    benchSink = hits;
+}
+
+// --- BRUSH ---
+
+static void RunEditWorld(void* ctx) {
+    int radius = *(int*)ctx;
+    for (int i = 0; i < EDIT_OPS; i++) {
+        EditWorld((i * 37) % GRID_W, (i * 53) % GRID_H, (i & 1) ? BLOCK_WATER : BLOCK_DIRT, radius);
+    }
+}
+
+// --- PATHFINDING ---
+
+static void RunFindPath(void* ctx) {
+    static int path[GRID_W * GRID_H];
+    long total = 0;
+    for (int i = 0; i < PATH_OPS; i++) {
+        total += FindPath((i * 37) % GRID_W, (i * 53) % GRID_H, (i * 71) % GRID_W, (i * 29) % GRID_H, path, GRID_W * GRID_H);
+    }
+    benchSink = total;
+}
+
+// Many agents sharing one field, as mobs chasing the player would
+static void RunFlowDirection(void* ctx) {
+    int field = GetFlowField(GRID_W / 2, GRID_H / 2);
+    float sum = 0;
+    for (int i = 0; i < FLOW_OPS; i++) sum += GetFlowDirection(field, (i * 37) % GRID_W, (i * 53) % GRID_H).x;
+    benchSink = (long)sum;
+}
+
+// --- WHOLE TICKS ---
+
+static void FillGrid(BlockType (*pick)(int x, int y), int life) {
+    for (int y = 0; y < GRID_H; y++) {
+        for (int x = 0; x < GRID_W; x++) {
+            Cell c = GetCell(x, y);
+            c.type = pick(x, y);
+            c.color = GetBlockColor(c.type);
+            c.life = (c.type == BLOCK_AIR || c.type == BLOCK_WOOD) ? 0 : life;
+            SetCell(x, y, c);
+        }
+    }
+    // Commit the new grid here, so the first timed tick doesn't pay for it
+    CommitTick();
+    CompactWorld();
+    ResetHistory();
+}
+
+static BlockType PickEmpty(int x, int y) { return BLOCK_AIR; }
+// Water everywhere with a sprinkling of air so it keeps churning
+static BlockType PickFlooded(int x, int y) { return ((x * 7 + y * 13) % 5 == 0) ? BLOCK_AIR : BLOCK_WATER; }
+// A wooden map with a line of fire every 16 rows
+static BlockType PickBurning(int x, int y) { return (y % 16 == 0) ? BLOCK_FIRE : BLOCK_WOOD; }
+
+static void SetupEmpty(void* ctx) { FillGrid(PickEmpty, 0); }
+static void SetupFlooded(void* ctx) { FillGrid(PickFlooded, 1000); }
+static void SetupBurning(void* ctx) { FillGrid(PickBurning, 150); }
+
+static void RunTicks(void* ctx) {
+    for (int i = 0; i < TICK_OPS; i++) UpdateWorld();
+}
+
+// --- WORLD BATCHES ---
+// ns per world-tick; the throughput line is the same number per second
+
+static void RunBatch(void* ctx) {
+    StepWorldBatch((WorldBatch*)ctx, BATCH_TICKS);
+}
+
+static void BenchBatch(const char* name, int threads) {
+    WorldBatch* batch = CreateWorldBatch(BATCH_WORLDS, threads, 1);
+    if (!batch) return;
+    const BenchResult* r = BenchRun(name, NULL, RunBatch, batch, BATCH_WORLDS * BATCH_TICKS);
+    if (r) printf("%-36s %12.0f world-ticks/s\n", "", 1e9 / r->nsPerOp);
+    DestroyWorldBatch(batch);
+}
+
+int main(int argc, char** argv) {
+    SetTraceLogLevel(LOG_WARNING);
+    InitReactions();
+    InitWorld();
+    Vector2 center = { SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f };
+    SetSimulationFocus((Camera2D){ .offset = center, .target = center, .zoom = 1.0f }); // As the game starts
+
+    BenchRun("GetDensity", NULL, RunGetDensity, NULL, HELPER_OPS);
+    BenchRun("IsSolid", NULL, RunIsSolid, NULL, HELPER_OPS);
+    BenchRun("CheckCollision/r12", NULL, RunCheckCollision, NULL, COLLISION_OPS);
+
+    int radii[] = { 1, 4, 16 };
+    for (int i = 0; i < 3; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "EditWorld/r%d", radii[i]);
+        BenchRun(name, NULL, RunEditWorld, &radii[i], EDIT_OPS);
+    }
+
+    BenchRun("FindPath/random", NULL, RunFindPath, NULL, PATH_OPS);
+    BenchRun("GetFlowDirection", NULL, RunFlowDirection, NULL, FLOW_OPS);
+
+    BenchRun("UpdateWorld/empty", SetupEmpty, RunTicks, NULL, TICK_OPS);
+    BenchRun("UpdateWorld/flooded", SetupFlooded, RunTicks, NULL, TICK_OPS);
+    BenchRun("UpdateWorld/burning", SetupBurning, RunTicks, NULL, TICK_OPS);
+
+    BenchBatch("StepWorldBatch/64x1", 1);
+    BenchBatch("StepWorldBatch/64xcpus", 0);
+
+    return BenchFinish(argc, argv, "world");
+}
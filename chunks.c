@@ -0,0 +1,171 @@
+#include "game.h"
+#include <string.h>
+
+// --- CHUNK STORAGE ---
+// The world is stored per chunk: one CHUNK_SIZE x CHUNK_SIZE tile with its
+// cells in Z-order (see GRID LAYOUT in physics.c). Each chunk uses the
+// cheapest of three forms for what it currently holds:
+//   CHUNK_UNIFORM  Every cell has the same value (palette[0]). Solid rock or
+//                  open air costs a few bytes, and UpdateWorld skips it.
+//   CHUNK_PALETTE  Up to CHUNK_PALETTE_MAX distinct values; each cell holds a
+//                  1, 2 or 4 bit index into the palette.
+//   CHUNK_FULL     A block from the world's ChunkPool with one CellState
+//                  per cell.
+//
+// ChunkSet promotes a chunk the moment its form can't hold the new value.
+// Demoting is left to CompactChunk, which runs once per tick on the chunks
+// that were written, so a cell flipping back and forth mid-tick never
+// reallocates anything.
+//
+// Every world owns its blocks (see ChunkPool in game.h), so worlds on
+// different threads never share an allocator. A chunk holds at most one
+// block, so the pool can't run out.
+
+static CellState* AllocBlock(ChunkPool* pool) {
+    if (pool->freeCount > 0) return pool->free[--pool->freeCount];
+    return pool->blocks[pool->used++];
+}
+
+static void FreeBlock(ChunkPool* pool, CellState* block) {
+    pool->free[pool->freeCount++] = block;
+}
+
+// --- PALETTE INDICES ---
+
+static int GetIndex(const Chunk* c, int k) {
+    int bit = k * c->bits;
+    return (c->indices[bit >> 3] >> (bit & 7)) & ((1 << c->bits) - 1);
+}
+
+static void SetIndex(Chunk* c, int k, int i) {
+    int bit = k * c->bits;
+    unsigned char mask = (unsigned char)(((1 << c->bits) - 1) << (bit & 7));
+    c->indices[bit >> 3] = (unsigned char)((c->indices[bit >> 3] & ~mask) | (i << (bit & 7)));
+}
+
+// Re-packs every index at a wider bit width
+static void WidenIndices(Chunk* c, int bits) {
+    unsigned char old[CHUNK_CELLS];
+    for (int k = 0; k < CHUNK_CELLS; k++) old[k] = (unsigned char)GetIndex(c, k);
+    c->bits = (unsigned char)bits;
+    for (int k = 0; k < CHUNK_CELLS; k++) SetIndex(c, k, old[k]);
+}
+
+static void MakeFull(ChunkPool* pool, Chunk* c) {
+    CellState* cells = AllocBlock(pool);
+    for (int k = 0; k < CHUNK_CELLS; k++) cells[k] = ChunkGet(c, k);
+    c->cells = cells;
+    c->kind = CHUNK_FULL;
+}
+
+// --- PUBLIC API ---
+
+CellState ChunkGet(const Chunk* c, int k) {
+    switch (c->kind) {
+        case CHUNK_UNIFORM: return c->palette[0];
+        case CHUNK_PALETTE: return c->palette[GetIndex(c, k)];
+        default: return c->cells[k];
+    }
+}
+
+void ChunkSet(ChunkPool* pool, Chunk* c, int k, CellState v) {
+    if (c->kind == CHUNK_FULL) {
+        c->cells[k] = v;
+        c->dirty = true;
+        return;
+    }
+    if (c->kind == CHUNK_UNIFORM) {
+        if (v == c->palette[0]) return;
+        c->kind = CHUNK_PALETTE;
+        c->bits = 1;
+        c->paletteCount = 1;
+        memset(c->indices, 0, sizeof(c->indices));
+    }
+    c->dirty = true;
+
+    int i = 0;
+    while (i < c->paletteCount && c->palette[i] != v) i++;
+    if (i == c->paletteCount) {
+        if (i == CHUNK_PALETTE_MAX) {
+            MakeFull(pool, c);
+            c->cells[k] = v;
+            return;
+        }
+        if (i == (1 << c->bits)) WidenIndices(c, c->bits * 2);
+        c->palette[c->paletteCount++] = v;
+    }
+    SetIndex(c, k, i);
+}
+
+void ChunkFill(ChunkPool* pool, Chunk* c, CellState v) {
+    if (c->cells) FreeBlock(pool, c->cells);
+    c->cells = NULL;
+    c->kind = CHUNK_UNIFORM;
+    c->palette[0] = v;
+    c->paletteCount = 1;
+    c->bits = 0;
+    c->dirty = false;
+}
+
+// Makes dst hold the same cells as src (reusing dst's block if it has one)
+void ChunkCopy(ChunkPool* pool, Chunk* dst, const Chunk* src) {
+    CellState* cells = dst->cells;
+    if (src->kind == CHUNK_FULL) {
+        if (!cells) cells = AllocBlock(pool);
+        memcpy(cells, src->cells, CHUNK_CELLS * sizeof(CellState));
+    } else if (cells) {
+        FreeBlock(pool, cells);
+        cells = NULL;
+    }
+    *dst = *src;
+    dst->cells = cells;
+}
+
+// Picks the smallest form for what the chunk holds now. Only the top-left
+// validW x validH cells count; the padding of edge chunks takes any value.
+void CompactChunk(ChunkPool* pool, Chunk* c, int validW, int validH) {
+    if (!c->dirty) return;
+    c->dirty = false;
+
+    CellState found[CHUNK_PALETTE_MAX];
+    unsigned char index[CHUNK_CELLS];
+    int count = 0;
+    bool edge = validW < CHUNK_SIZE || validH < CHUNK_SIZE;
+    for (int k = 0; k < CHUNK_CELLS; k++) {
+        index[k] = 0;
+        if (edge && (MortonDecode(k) >= validW || MortonDecode(k >> 1) >= validH)) continue;
+
+        CellState v = ChunkGet(c, k);
+        int i = 0;
+        while (i < count && found[i] != v) i++;
+        if (i == count) {
+            if (count == CHUNK_PALETTE_MAX) return; // Busy: stays full
+            found[count++] = v;
+        }
+        index[k] = (unsigned char)i;
+    }
+
+    if (count == 1) {
+        ChunkFill(pool, c, found[0]);
+        return;
+    }
+    if (c->cells) FreeBlock(pool, c->cells);
+    c->cells = NULL;
+    c->kind = CHUNK_PALETTE;
+    c->bits = (count <= 2) ? 1 : (count <= 4) ? 2 : 4;
+    c->paletteCount = (unsigned char)count;
+    memcpy(c->palette, found, count * sizeof(CellState));
+    for (int k = 0; k < CHUNK_CELLS; k++) SetIndex(c, k, index[k]);
+}
+
+int ChunkBytes(const Chunk* c) {
+    return (int)sizeof(Chunk) + ((c->kind == CHUNK_FULL) ? CHUNK_CELLS * (int)sizeof(CellState) : 0);
+}
+
+// x (or y, after a shift by 1) of in-chunk index k: gathers the even bits
+int MortonDecode(int k) {
+    k &= 0x55;
+    k = (k | (k >> 1)) & 0x33;
+    k = (k | (k >> 2)) & 0x0F;
+    return k;
+}
@@ -14,6 +14,22 @@
 #define GRID_H (SCREEN_HEIGHT / CELL_SIZE)
 #define MAX_TRAIL_LENGTH 10 // maximum number of positions to store in the trail
 
+// --- SIMULATION LOD ---
+#define CHUNK_SIZE 16 // Cells per chunk side
+#define CHUNKS_X ((GRID_W + CHUNK_SIZE - 1) / CHUNK_SIZE)
+#define CHUNKS_Y ((GRID_H + CHUNK_SIZE - 1) / CHUNK_SIZE)
+#define LOD_TIER1_DIST 64.0f  // Cells off screen: beyond this, every 2nd tick
+#define LOD_TIER2_DIST 128.0f // Every 4th tick
+#define LOD_TIER3_DIST 192.0f // Every 8th tick
+#define LOD_MAX_STEPS 8       // Most ticks a chunk may catch up in one update
+
+#define CHUNK_CELLS (CHUNK_SIZE * CHUNK_SIZE)
+
+// --- HISTORY (TIME REWIND) ---
+#define HISTORY_SECONDS 20              // How far back we can rewind
+#define HISTORY_KEYFRAME_INTERVAL 60    // Ticks between full snapshots (1 second)
+#define HISTORY_BUDGET (16 * 1024 * 1024) // Hard cap for compressed history (bytes)
+
 // --- BLOCK TYPES ---
 typedef enum {
     BLOCK_AIR = 0,
@@ -28,6 +44,168 @@ typedef enum {
     BLOCK_COUNT
 } BlockType;
 
+// --- REPLICATION (LOCAL SPECTATORS) ---
+#define REPL_DEFAULT_PORT 47800
+#define REPL_PACKET_SIZE 8192                  // UDP payload per datagram (loopback)
+#define REPL_BYTES_PER_SECOND (2 * 1024 * 1024) // Bandwidth cap
+#define REPL_KEYFRAME_CHUNKS 2                  // Full chunks refreshed per tick
+
+// --- LIGHTING (see light.c) ---
+#define LIGHT_MAX 15
+#define LIGHT_OPAQUE 255    // Opacity of walls: lit on the surface, nothing passes
+#define LIGHT_AMBIENT 0.45f // Brightness of a cell with no light at all
+
+// --- PATHFINDING (see nav.c) ---
+#define NAV_MAX_FIELDS 4         // Flow fields cached at once (one per shared goal)
+#define NAV_UNREACHABLE 0xFFFF   // Flow distance of cells with no way to the goal
+
+// --- STRUCTURAL INTEGRITY (see rigid.c) ---
+#define RIGID_MAX_BODIES 32  // Loose pieces at once; past this, pieces just stay put
+#define RIGID_MAX_CELLS 256  // Pieces bigger than this never come loose
+#define RIGID_MIN_CELLS 4    // Crumbs smaller than this stay where they are
+#define RIGID_SAVE_MAX_BYTES (1 + RIGID_MAX_BODIES * (16 + 2 + 3 * RIGID_MAX_CELLS)) // SaveRigidBodies output
+
+// --- CHEMISTRY (see reactions.c) ---
+#define DENSITY_LIQUID 50 // Anything lighter than water counts as a gas
+
+// Per-material behaviour flags
+#define MAT_MOVES    0x01 // Random-walks into cells it can displace
+#define MAT_SETTLES  0x02 // Each move costs 1 life; stops moving at 0
+#define MAT_DECAYS   0x04 // Loses 1 life per tick, then turns into decayInto
+#define MAT_FLICKER  0x08 // Re-rolls its color every tick
+#define MAT_REACTIVE 0x10 // Has reactions, scans its 3x3 neighbourhood
+
+typedef struct {
+    unsigned char moveSides;  // Tries to move 1 in N ticks
+    unsigned char decayInto;  // BlockType it becomes when life runs out
+    unsigned char flags;      // MAT_*
+    int spawnLife;            // Life given to a freshly created cell
+    unsigned char emitLight;  // Light level it gives off (0 = none)
+    unsigned char opacity;    // Extra light lost entering it (LIGHT_OPAQUE = stops light)
+} MaterialRule;
+
+#define REACT_DISPLACE 0x01 // Material A may move into B's cell
+
+// One entry of the (A, B) matrix. A = cell being updated, B = its neighbour.
+typedef struct {
+    unsigned char self;      // What A turns into
+    unsigned char other;     // What B turns into
+    unsigned char byproduct; // Spawned into an empty cell next to B (BLOCK_AIR = none)
+    unsigned char flags;     // REACT_*
+    unsigned short sides;    // Reaction happens 1 in N ticks (0 = never)
+} Reaction;
+
+extern Reaction ReactionMatrix[BLOCK_COUNT * BLOCK_COUNT];
+extern MaterialRule Materials[BLOCK_COUNT];
+#define GetReaction(a, b) (&ReactionMatrix[(a) * BLOCK_COUNT + (b)])
+
+// --- SIMULATION STATS (see stats.c) ---
+#define STATS_HISTORY 120       // Ticks kept for the debug panel histograms
+#define STATS_DUMP_INTERVAL 300 // Ticks buffered between writes to the dump file
+
+typedef struct {
+    int visited;            // Cells the physics pass looked at (LOD skips excluded)
+    int active;             // Of those, cells with any behaviour (fluids, gases, fire)
+    int moved[BLOCK_COUNT]; // Successful moves, by material
+    int reactions;          // Reaction matrix entries that fired
+    int ignitions;          // Cells set alight by a reaction
+    int settled;            // Fluids that spent their last move this tick
+    int edited;             // Cells changed by the brush
+    int relit;              // Cells whose light level was recomputed
+    int navRebuilt;         // Pathfinding chunks rebuilt after walls changed
+    int detached;           // Solid pieces that broke loose into rigid bodies
+    float tickMs;           // Time spent in UpdateWorld
+    float frameMs;          // Frame time when the tick ran
+} TickStats;
+
+extern TickStats LiveStats; // Counters for the tick in progress
+extern const char* BlockNames[];
+
+// --- MEMORY ACCOUNTING (see memory.c) ---
+typedef enum { MEM_WORLD = 0, MEM_RENDER, MEM_ENTITIES, MEM_PARTICLES, MEM_UI, MEM_TAG_COUNT } MemTag;
+
+typedef struct {
+    long long live;        // Heap bytes held now
+    long long peak;        // Most heap bytes held at once
+    size_t staticBytes;    // Fixed arrays registered with TrackStatic
+    long long allocs;      // Allocations ever made
+    long long allocated;   // Bytes ever allocated
+    int frameAllocs;       // Allocations during the last frame
+    size_t frameBytes;     // Bytes allocated during the last frame
+    float bytesPerSecond;  // Allocation rate over about the last second
+} MemoryStats;
+
+extern const char* MemTagNames[MEM_TAG_COUNT];
+
+// --- CHUNK STORAGE (see chunks.c) ---
+// A stored cell is packed into 32 bits: type, floor, active and life.
+// Colors are not stored; they are derived from the block type and position.
+typedef unsigned int CellState;
+#define STATE_TYPE(s)   ((BlockType)((s) & 0xFF))
+#define STATE_FLOOR(s)  ((BlockType)(((s) >> 8) & 0x7F))
+#define STATE_ACTIVE(s) ((((s) >> 15) & 1) != 0)
+#define STATE_LIFE(s)   ((int)(short)((s) >> 16))
+#define MAKE_STATE(type, floor, life, active) \
+    ((CellState)(type) | ((CellState)(floor) << 8) | ((active) ? 0x8000u : 0u) | ((CellState)(unsigned short)(short)(life) << 16))
+#define STATE_WITH_TYPE(s, type) (((s) & ~0xFFu) | (CellState)(type))
+#define STATE_WITH_LIFE(s, life) (((s) & 0xFFFFu) | ((CellState)(unsigned short)(short)(life) << 16))
+
+#define CHUNK_PALETTE_MAX 16 // Most distinct values before a chunk goes full
+
+typedef enum { CHUNK_UNIFORM = 0, CHUNK_PALETTE, CHUNK_FULL } ChunkKind;
+
+typedef struct {
+    unsigned char kind;         // ChunkKind
+    unsigned char bits;         // Palette index width (1, 2 or 4)
+    unsigned char paletteCount;
+    bool dirty;                 // Written since the last CompactChunk
+    CellState palette[CHUNK_PALETTE_MAX]; // palette[0] is the whole chunk when uniform
+    unsigned char indices[CHUNK_CELLS / 2]; // CHUNK_PALETTE: packed indices
+    CellState* cells;           // CHUNK_FULL: CHUNK_CELLS values (from the ChunkPool)
+} Chunk;
+
+#define CHUNK_COUNT (CHUNKS_X * CHUNKS_Y) // Edge tiles are padded
+#define CHUNK_POOL_BLOCKS (2 * CHUNK_COUNT) // Both buffers full everywhere
+
+// Blocks for full chunks. Each world has its own; `used` counts blocks ever
+// handed out, returned ones go on the free list.
+typedef struct {
+    CellState blocks[CHUNK_POOL_BLOCKS][CHUNK_CELLS];
+    CellState* free[CHUNK_POOL_BLOCKS];
+    int freeCount;
+    int used;
+} ChunkPool;
+
+// --- WORLD INSTANCES (see physics.c, world.c) ---
+// Everything one cell simulation needs. The game plays in one main world
+// (static in physics.c); batches of headless worlds for level validation or
+// agent training live in one arena each and step on a thread pool.
+// Lighting, pathfinding, rigid bodies, surfaces, history and replication
+// only follow the main world.
+#define WORLD_MAX_THREADS 64
+
+typedef struct {
+    Chunk storeA[CHUNK_COUNT];   // Double buffer, one Chunk per tile
+    Chunk storeB[CHUNK_COUNT];
+    Chunk* grid;                 // Current state (storeA or storeB)
+    Chunk* nextGrid;             // Being written this tick
+    ChunkPool pool;
+
+    int changedCells[GRID_W * GRID_H]; // Touched since the last commit
+    int changedCount;
+    bool changedFlag[GRID_H][GRID_W];
+
+    int simTick;
+    int chunkLastTick[CHUNKS_Y][CHUNKS_X];
+    Rectangle simView;           // In cells: what the camera shows
+    unsigned int rng;            // xorshift32 state, never 0
+
+    TickStats* stats;            // LiveStats for the main world, else ownStats
+    TickStats ownStats;
+} World;
+
+typedef struct WorldBatch WorldBatch;
+
 // --- ENTITIES ---
 typedef struct {
     Vector2 position; 
@@ -57,6 +235,8 @@ typedef struct {
 // --- PROTOTYPES ---
 void InitWorld();
 void UpdateWorld(); // Cellular Automata Logic
+void SetSimulationFocus(Camera2D camera); // Chunks on (or near) screen run at full rate
+int GetChunkLodTier(int cx, int cy);
 void DrawWorld();
 
 void InitPlayer(Player* p);
@@ -64,14 +244,126 @@ void UpdateTrail(Vector2* trailPositions, Player p);
 void UpdatePlayer(Player* p, float dt);
 void DrawPlayer(Player* p);
 Color GetBlockColor(BlockType t);
+Color GetBlockColorAt(BlockType t, int x, int y); // Same noise, but fixed per position
 
 // Interaction
 void EditWorld(int x, int y, BlockType type, int radius);
 bool IsSolid(BlockType t);
+bool IsFluid(BlockType t); // Water and lava
+bool IsValid(int x, int y); // Inside the grid
 int GetDensity(BlockType t); // New Density Check
+bool CheckCollision(Vector2 pos, float radius); // Player vs solid cells
+void InitReactions(); // Compiles the reaction matrix (call once at startup)
+
+// Chunk Storage (used by physics.c)
+CellState ChunkGet(const Chunk* c, int k);
+void ChunkSet(ChunkPool* pool, Chunk* c, int k, CellState v);
+void ChunkFill(ChunkPool* pool, Chunk* c, CellState v);
+void ChunkCopy(ChunkPool* pool, Chunk* dst, const Chunk* src);
+void CompactChunk(ChunkPool* pool, Chunk* c, int validW, int validH);
+int ChunkBytes(const Chunk* c);
+int MortonDecode(int k);
+void CompactWorld(); // Re-packs chunks written outside UpdateWorld (edits, rewind, spectating)
+void GetWorldStorage(int* uniform, int* palette, int* full, int* bytes);
+
+// World Access (for systems outside physics.c)
+Cell GetCell(int x, int y);
+BlockType GetCellType(int x, int y); // Cheaper than GetCell when only the type matters
+void SetCell(int x, int y, Cell c);
+bool CellEquals(const Cell* a, const Cell* b);
+void CommitTick(); // Hands the cells changed since the last call to integrity, lighting, pathfinding, surfaces, history and replication
+void CommitSpectatorTick(); // Lighting and surfaces only, for streamed cells
+void CommitRewindTick();    // Integrity, lighting, pathfinding and surfaces, after RewindWorld
+
+// World Instances (headless worlds besides the main one)
+void GenerateWorld(World* w, unsigned int seed); // Fresh terrain, same seed = same world
+void StepWorld(World* w);                        // One tick, cells only
+BlockType GetWorldCellType(const World* w, int x, int y);
+void BrushWorld(World* w, int x, int y, BlockType type, int radius); // EditWorld on any world
+const TickStats* GetWorldStats(const World* w);  // Counters of its last tick
+WorldBatch* CreateWorldBatch(int count, int threads, unsigned int seed); // threads <= 0: one per CPU
+void StepWorldBatch(WorldBatch* b, int ticks);
+World* GetBatchWorld(WorldBatch* b, int i);
+void DestroyWorldBatch(WorldBatch* b);
+
+// Memory Accounting (tagged allocators, see MemTag)
+void* TagAlloc(MemTag tag, size_t size);
+void* TagCalloc(MemTag tag, size_t count, size_t size);
+void* TagRealloc(MemTag tag, void* p, size_t size);
+void TagFree(void* p);
+void TrackExternal(MemTag tag, long long bytes); // Buffers raylib allocated for us
+void TrackStatic(MemTag tag, const char* name, size_t bytes);
+void MemoryEndFrame();
+const MemoryStats* GetMemoryStats(MemTag tag);
+void PrintMemoryReport(FILE* f); // At exit
+void DrawMemoryPanel(); // Toggled with F5
+
+// Lighting
+void ResetLight();
+void LightCommitTick(const int* changed, int count);
+int GetLight(int x, int y);
+
+// Pathfinding (HPA* over chunks, plus shared flow fields)
+bool NavWalkable(BlockType t);
+void ResetNav();
+void NavCommitTick(const int* changed, int count);
+int FindPath(int sx, int sy, int gx, int gy, int* path, int maxLen);
+int GetFlowField(int gx, int gy);
+int GetFlowDistance(int field, int x, int y);
+Vector2 GetFlowDirection(int field, int x, int y);
+void DrawNavDebug(Vector2 goal, Vector2 from); // Toggled with F4
+
+// Structural Integrity (loose pieces of solid become rigid bodies)
+void ResetRigidBodies();
+void ClearRigidBodies();
+void RigidCommitTick(const int* changed, int count);
+void UpdateRigidBodies();
+bool PushRigidBodies(Vector2 pos, float radius, Vector2 velocity);
+void DrawRigidBodies();
+int GetRigidBodyCount();
+int SaveRigidBodies(unsigned char* out);
+int LoadRigidBodies(const unsigned char* in);
+
+// Surfaces (cached marching-squares meshes for liquids and wall outlines)
+void ResetSurfaces();
+void SurfaceCommitTick(const int* changed, int count);
+void DrawSurfaces();
+
+// History (Time Rewind)
+void ResetHistory();
+void HistoryCommitTick(const int* changed, int count);
+bool RewindWorld(int ticks);
+int GetHistoryTicks();
+int GetHistoryBytes();
+
+// Replication (run with --serve or --spectate)
+bool StartReplicationServer(int port);
+void ReplicationServerTick(const int* changed, int count);
+bool StartSpectator(int port);
+void PollSpectator();
+int GetReplicationBytes();
+bool IsReplicating();
+
+// Cell Codec (shared by anything that serializes cells)
+#define CELL_MAX_BYTES 8 // mask + type + floor + life (varint)
+int WriteVarint(unsigned char* out, unsigned int v);
+int ReadVarint(const unsigned char* in, unsigned int* v);
+int EncodeCell(unsigned char* out, const Cell* base, const Cell* c);
+int DecodeCell(const unsigned char* in, const Cell* base, Cell* out);
+int MeasureVarint(const unsigned char* in, int avail); // 0 = truncated (untrusted input)
+int MeasureCell(const unsigned char* in, int avail);   // 0 = truncated (untrusted input)
+
+// Stats (run with --stats file.csv / file.json to dump every tick)
+void CommitStats(float tickMs);
+const TickStats* GetTickStats(int ago);
+int GetStatsTickCount();
+int GetMovedTotal(const TickStats* s);
+bool StartStatsDump(const char* path);
+void StopStatsDump();
 
 // UI
 void DrawHUD(Player* p, Inventory* inv);
+void DrawStatsPanel(); // Toggled with F3
 
 // FX
 void Trail(Player* p, Vector2 *trailPositions);
@@ -0,0 +1,308 @@
+#include "game.h"
+#include <string.h>
+
+// --- HISTORY RING (TIME REWIND) ---
+// Every tick we store only the cells that changed (a "delta"), and every
+// HISTORY_KEYFRAME_INTERVAL ticks a full snapshot (a "keyframe").
+// To go back to tick T we load the closest keyframe before T and replay the
+// deltas forward. No re-simulation, just decoding a few hundred KB.
+//
+// Cells of a loose rigid body are AIR in the grid while it slides, so every
+// record also carries the bodies as they were at its tick (SaveRigidBodies).
+//
+// Records live in one fixed byte ring (HISTORY_BUDGET). When it fills up the
+// oldest keyframe and its deltas are dropped, so memory never grows.
+
+#define HISTORY_TICKS (HISTORY_SECONDS * 60)
+#define HISTORY_MAX_RECORDS (HISTORY_TICKS + 2 * HISTORY_KEYFRAME_INTERVAL)
+
+typedef struct {
+    int tick;      // World tick this record brings us to
+    int offset;    // Start inside historyData
+    int size;      // Encoded bytes
+    int cellBytes; // Of which cells; the rigid bodies follow
+    bool keyframe; // Full snapshot (true) or changed cells only (false)
+} HistoryRecord;
+
+static unsigned char historyData[HISTORY_BUDGET];
+static unsigned char scratch[GRID_W * GRID_H * (CELL_MAX_BYTES + 5) + 5 + RIGID_SAVE_MAX_BYTES];
+
+static HistoryRecord records[HISTORY_MAX_RECORDS];
+static int firstRecord = 0; // Oldest record (ring index)
+static int recordCount = 0;
+static int usedBytes = 0;
+
+static int historyTick = 0;         // Tick of the newest committed state
+static int lastKeyframeTick = 0;
+
+// What the world looked like at historyTick. Deltas are diffed against this.
+static Cell shadow[GRID_H * GRID_W];
+
+// --- CELL CODEC ---
+// A cell is written as a 1-byte mask of the fields that differ from a base
+// cell, followed by only those fields. Colors are not coded: they follow from
+// type and position (GetCell derives them, SetCell ignores them), so a decoded
+// cell keeps its base's colors. Neighbouring cells of the same block are just
+// the mask byte.
+#define CODEC_TYPE        0x01
+#define CODEC_FLOOR       0x02
+#define CODEC_LIFE        0x04
+#define CODEC_ACTIVE      0x08
+#define CODEC_ACTIVE_ON   0x10
+
+// Same stored state. Colors are left out: at the same position they follow from the type.
+bool CellEquals(const Cell* a, const Cell* b) {
+    return a->type == b->type && a->life == b->life && a->floor == b->floor && a->active == b->active;
+}
+
+int WriteVarint(unsigned char* out, unsigned int v) {
+    int n = 0;
+    while (v >= 0x80) { out[n++] = (unsigned char)(v | 0x80); v >>= 7; }
+    out[n++] = (unsigned char)v;
+    return n;
+}
+
+int ReadVarint(const unsigned char* in, unsigned int* v) {
+    int n = 0, shift = 0;
+    *v = 0;
+    do {
+        *v |= (unsigned int)(in[n] & 0x7F) << shift;
+        shift += 7;
+    } while (in[n++] & 0x80);
+    return n;
+}
+
+// Signed values (life, index steps) are zigzagged so small negatives stay small
+static unsigned int ZigZag(int v) { return ((unsigned int)v << 1) ^ (unsigned int)(v >> 31); }
+static int UnZigZag(unsigned int v) { return (int)(v >> 1) ^ -(int)(v & 1); }
+
+int EncodeCell(unsigned char* out, const Cell* base, const Cell* c) {
+    unsigned char mask = 0;
+    if (c->type != base->type) mask |= CODEC_TYPE;
+    if (c->floor != base->floor) mask |= CODEC_FLOOR;
+    if (c->life != base->life) mask |= CODEC_LIFE;
+    if (c->active != base->active) mask |= CODEC_ACTIVE | (c->active ? CODEC_ACTIVE_ON : 0);
+
+    int n = 0;
+    out[n++] = mask;
+    if (mask & CODEC_TYPE) out[n++] = (unsigned char)c->type;
+    if (mask & CODEC_FLOOR) out[n++] = (unsigned char)c->floor;
+    if (mask & CODEC_LIFE) n += WriteVarint(out + n, ZigZag(c->life));
+    return n;
+}
+
+int DecodeCell(const unsigned char* in, const Cell* base, Cell* out) {
+    int n = 0;
+    unsigned char mask = in[n++];
+    *out = *base;
+    if (mask & CODEC_TYPE) out->type = (BlockType)in[n++];
+    if (mask & CODEC_FLOOR) out->floor = (BlockType)in[n++];
+    if (mask & CODEC_LIFE) { unsigned int v; n += ReadVarint(in + n, &v); out->life = UnZigZag(v); }
+    if (mask & CODEC_ACTIVE) out->active = (mask & CODEC_ACTIVE_ON) != 0;
+    return n;
+}
+
+// Bytes of the varint at in, or 0 if it runs past avail (or past 32 bits).
+// For input nobody vouches for: check before ReadVarint.
+int MeasureVarint(const unsigned char* in, int avail) {
+    for (int n = 0; n < avail && n < 5; n++) {
+        if (!(in[n] & 0x80)) return n + 1;
+    }
+    return 0;
+}
+
+// Bytes of the encoded cell at in, or 0 if it runs past avail. Check before DecodeCell.
+int MeasureCell(const unsigned char* in, int avail) {
+    if (avail < 1) return 0;
+    unsigned char mask = in[0];
+    int n = 1;
+    if (mask & CODEC_TYPE) n += 1;
+    if (mask & CODEC_FLOOR) n += 1;
+    if (n > avail) return 0;
+    if (mask & CODEC_LIFE) {
+        int v = MeasureVarint(in + n, avail - n);
+        if (v == 0) return 0;
+        n += v;
+    }
+    return n;
+}
+
+// --- RECORD ENCODING ---
+
+// Keyframe: every cell, each diffed against the cell before it in scan order
+static int EncodeKeyframe(unsigned char* out) {
+    Cell prev = {0};
+    int n = 0;
+    for (int i = 0; i < GRID_W * GRID_H; i++) {
+        shadow[i] = GetCell(i % GRID_W, i / GRID_W);
+        n += EncodeCell(out + n, &prev, &shadow[i]);
+        prev = shadow[i];
+    }
+    return n;
+}
+
+static void DecodeKeyframe(const unsigned char* in) {
+    Cell prev = {0};
+    int n = 0;
+    for (int i = 0; i < GRID_W * GRID_H; i++) {
+        n += DecodeCell(in + n, &prev, &shadow[i]);
+        prev = shadow[i];
+    }
+}
+
+// Delta: [count] then ([index step][cell diffed against the previous tick])...
+// Cells that were touched but ended up identical are dropped here.
+static int EncodeDelta(unsigned char* out, const int* changed, int count) {
+    unsigned char* body = out + 5; // Leave room for the count varint
+    int n = 0, written = 0, lastIndex = 0;
+    for (int k = 0; k < count; k++) {
+        int i = changed[k];
+        Cell c = GetCell(i % GRID_W, i / GRID_W);
+        if (CellEquals(&shadow[i], &c)) continue;
+        n += WriteVarint(body + n, ZigZag(i - lastIndex));
+        n += EncodeCell(body + n, &shadow[i], &c);
+        shadow[i] = c;
+        lastIndex = i;
+        written++;
+    }
+    int header = WriteVarint(out, (unsigned int)written);
+    memmove(out + header, body, n);
+    return header + n;
+}
+
+static void DecodeDelta(const unsigned char* in) {
+    unsigned int count;
+    int n = ReadVarint(in, &count);
+    int index = 0;
+    for (unsigned int k = 0; k < count; k++) {
+        unsigned int step;
+        n += ReadVarint(in + n, &step);
+        index += UnZigZag(step);
+        n += DecodeCell(in + n, &shadow[index], &shadow[index]);
+    }
+}
+
+// --- RING MANAGEMENT ---
+
+static HistoryRecord* RecordAt(int k) {
+    return &records[(firstRecord + k) % HISTORY_MAX_RECORDS];
+}
+
+static void DropOldest() {
+    usedBytes -= records[firstRecord].size;
+    firstRecord = (firstRecord + 1) % HISTORY_MAX_RECORDS;
+    recordCount--;
+}
+
+// Deltas are useless without the keyframe before them
+static void DropUntilKeyframe() {
+    while (recordCount > 0 && !records[firstRecord].keyframe) DropOldest();
+}
+
+static bool Overlaps(const HistoryRecord* r, int offset, int size) {
+    return r->offset < offset + size && offset < r->offset + r->size;
+}
+
+static void PushRecord(const unsigned char* data, int size, int cellBytes, bool keyframe) {
+    // Place right after the newest record, wrapping to the start if it won't fit
+    int offset = 0;
+    if (recordCount > 0) {
+        HistoryRecord* last = RecordAt(recordCount - 1);
+        offset = last->offset + last->size;
+        if (offset + size > HISTORY_BUDGET) {
+            // Whatever sits past the newest record is older than everything at the start
+            while (recordCount > 0 && records[firstRecord].offset >= offset) DropOldest();
+            offset = 0;
+        }
+    }
+
+    // Budget: evict whatever the new record lands on
+    while (recordCount > 0 && (recordCount == HISTORY_MAX_RECORDS || Overlaps(&records[firstRecord], offset, size))) {
+        DropOldest();
+    }
+    DropUntilKeyframe();
+
+    memcpy(historyData + offset, data, size);
+    HistoryRecord* r = RecordAt(recordCount++);
+    r->tick = historyTick;
+    r->offset = offset;
+    r->size = size;
+    r->cellBytes = cellBytes;
+    r->keyframe = keyframe;
+    usedBytes += size;
+    DropUntilKeyframe(); // Only if the budget left us without a keyframe at all
+
+    // Window: once a newer keyframe can still reach HISTORY_SECONDS back, the older group can go
+    while (recordCount > 0) {
+        int next = 1;
+        while (next < recordCount && !RecordAt(next)->keyframe) next++;
+        if (next >= recordCount || RecordAt(next)->tick > historyTick - HISTORY_TICKS) break;
+        for (int k = 0; k < next; k++) DropOldest();
+    }
+}
+
+// --- PUBLIC API ---
+
+void ResetHistory() {
+    TrackStatic(MEM_WORLD, "history", sizeof(historyData) + sizeof(scratch) + sizeof(records) + sizeof(shadow));
+    firstRecord = 0;
+    recordCount = 0;
+    usedBytes = 0;
+    historyTick = 0;
+    lastKeyframeTick = 0;
+}
+
+// Called once per UpdateWorld with every cell that may have changed since the last call
+void HistoryCommitTick(const int* changed, int count) {
+    historyTick++;
+    bool keyframe = recordCount == 0 || historyTick - lastKeyframeTick >= HISTORY_KEYFRAME_INTERVAL;
+    int cellBytes = keyframe ? EncodeKeyframe(scratch) : EncodeDelta(scratch, changed, count);
+    int size = cellBytes + SaveRigidBodies(scratch + cellBytes);
+    PushRecord(scratch, size, cellBytes, keyframe);
+    if (keyframe) lastKeyframeTick = historyTick;
+}
+
+// Restores the world to how it was `ticks` ticks ago (clamped to the oldest record).
+// Everything after that point is discarded, so the simulation continues from there.
+bool RewindWorld(int ticks) {
+    if (recordCount == 0 || ticks <= 0) return false;
+    int target = historyTick - ticks;
+    if (target < records[firstRecord].tick) target = records[firstRecord].tick;
+
+    // Newest keyframe at or before the target
+    int key = recordCount - 1;
+    while (key > 0 && !(RecordAt(key)->keyframe && RecordAt(key)->tick <= target)) key--;
+
+    DecodeKeyframe(historyData + RecordAt(key)->offset);
+    int last = key;
+    for (int k = key + 1; k < recordCount && RecordAt(k)->tick <= target; k++) {
+        DecodeDelta(historyData + RecordAt(k)->offset);
+        last = k;
+    }
+
+    // Push the rebuilt state back into the world (only cells that differ)
+    for (int i = 0; i < GRID_W * GRID_H; i++) {
+        int x = i % GRID_W, y = i / GRID_W;
+        Cell c = GetCell(x, y);
+        if (!CellEquals(&c, &shadow[i])) SetCell(x, y, shadow[i]);
+    }
+    // And the pieces that were sliding around then (bodies from later are cells again)
+    LoadRigidBodies(historyData + RecordAt(last)->offset + RecordAt(last)->cellBytes);
+
+    // Drop the future we just undid
+    while (recordCount > last + 1) {
+        recordCount--;
+        usedBytes -= RecordAt(recordCount)->size;
+    }
+    historyTick = RecordAt(last)->tick;
+    lastKeyframeTick = RecordAt(key)->tick;
+    return true;
+}
+
+int GetHistoryTicks() {
+    return (recordCount > 0) ? historyTick - records[firstRecord].tick : 0;
+}
+
+int GetHistoryBytes() {
+    return usedBytes;
+}
@@ -0,0 +1,143 @@
+#include "game.h"
+#include <string.h>
+
+// --- LIGHTING ---
+// Every cell has a light level (0..LIGHT_MAX). Emissive materials (fire,
+// lava) are sources; light loses 1 per cell it travels plus the opacity of
+// the cell it enters. Opaque cells (walls) get lit on their surface but
+// don't pass light on.
+//
+// Nothing is ever relit from scratch during play. When a cell changes type
+// we run two flood fills from it, the way Minecraft does:
+//   remove: clear every cell that was lit through this one (its level is
+//           lower than ours), and collect the lit cells at the border;
+//   add:    spread light again from the border and from any source.
+// So a burning forest only relights around the cells that caught fire or
+// burned out this tick.
+
+#define LIGHT_CELLS (GRID_W * GRID_H)
+#define QUEUE_SIZE (1 << 17) // Ring buffers (power of two); a cell may be queued a few times
+#define QUEUE_MASK (QUEUE_SIZE - 1)
+#if LIGHT_MAX > 15
+#error "The remove queue packs a level into 4 bits"
+#endif
+
+static unsigned char light[LIGHT_CELLS];
+static unsigned char seenType[LIGHT_CELLS]; // Block type the light field was built with
+
+static int addQueue[QUEUE_SIZE];
+static unsigned int addHead = 0, addTail = 0;
+static int removeQueue[QUEUE_SIZE]; // (cell << 4) | level it had
+static unsigned int removeHead = 0, removeTail = 0;
+static bool overflow = false;
+
+static void PushAdd(int i) {
+    if (addTail - addHead >= QUEUE_SIZE) { overflow = true; return; }
+    addQueue[addTail++ & QUEUE_MASK] = i;
+}
+
+static void PushRemove(int i, int level) {
+    if (removeTail - removeHead >= QUEUE_SIZE) { overflow = true; return; }
+    removeQueue[removeTail++ & QUEUE_MASK] = (i << 4) | level;
+}
+
+// Up to 4 neighbour indices of cell i, returns how many
+static int Neighbours(int i, int* out) {
+    int x = i % GRID_W, y = i / GRID_W, n = 0;
+    if (x > 0) out[n++] = i - 1;
+    if (x < GRID_W - 1) out[n++] = i + 1;
+    if (y > 0) out[n++] = i - GRID_W;
+    if (y < GRID_H - 1) out[n++] = i + GRID_W;
+    return n;
+}
+
+static void PropagateRemove() {
+    int around[4];
+    while (removeHead != removeTail) {
+        int entry = removeQueue[removeHead++ & QUEUE_MASK];
+        int i = entry >> 4, level = entry & 0xF;
+        int count = Neighbours(i, around);
+        for (int k = 0; k < count; k++) {
+            int n = around[k];
+            if (light[n] == 0) continue;
+            if (light[n] < level) {
+                // Lit through us: clear it (a source keeps its own glow) and keep going
+                int old = light[n];
+                light[n] = Materials[seenType[n]].emitLight;
+                LiveStats.relit++;
+                PushRemove(n, old);
+                if (light[n] > 0) PushAdd(n);
+            } else {
+                // Lit by something else: it will flow back into the cleared area
+                PushAdd(n);
+            }
+        }
+    }
+}
+
+static void PropagateAdd() {
+    int around[4];
+    while (addHead != addTail) {
+        int i = addQueue[addHead++ & QUEUE_MASK];
+        int level = light[i];
+        const MaterialRule* m = &Materials[seenType[i]];
+        if (level <= 1 || (m->opacity == LIGHT_OPAQUE && m->emitLight == 0)) continue;
+
+        int count = Neighbours(i, around);
+        for (int k = 0; k < count; k++) {
+            int n = around[k];
+            int opacity = Materials[seenType[n]].opacity;
+            int next = level - 1 - ((opacity == LIGHT_OPAQUE) ? 0 : opacity);
+            if (next > light[n]) {
+                light[n] = (unsigned char)next;
+                LiveStats.relit++;
+                PushAdd(n);
+            }
+        }
+    }
+}
+
+// Full rebuild. Only for a new map (or if an update ever overflows the queues).
+void ResetLight() {
+    TrackStatic(MEM_WORLD, "light", sizeof(light) + sizeof(seenType) + sizeof(addQueue) + sizeof(removeQueue));
+    memset(light, 0, sizeof(light));
+    addHead = addTail = removeHead = removeTail = 0;
+    overflow = false;
+    for (int i = 0; i < LIGHT_CELLS; i++) {
+        seenType[i] = (unsigned char)GetCellType(i % GRID_W, i / GRID_W);
+        light[i] = Materials[seenType[i]].emitLight;
+        if (light[i] > 0) PushAdd(i);
+    }
+    PropagateAdd();
+}
+
+// Called once per committed tick with every cell that may have changed
+void LightCommitTick(const int* changed, int count) {
+    int around[4];
+    for (int c = 0; c < count; c++) {
+        int i = changed[c];
+        BlockType type = GetCellType(i % GRID_W, i / GRID_W);
+        if (type == seenType[i]) continue; // Life or color only, same light
+
+        seenType[i] = (unsigned char)type;
+        int old = light[i];
+        light[i] = Materials[type].emitLight;
+        if (old > 0) PushRemove(i, old);
+        if (light[i] > 0) PushAdd(i);
+
+        // It may let more light through now (a wall was dug out)
+        int n = Neighbours(i, around);
+        for (int k = 0; k < n; k++) {
+            if (light[around[k]] > 0) PushAdd(around[k]);
+        }
+    }
+    if (removeHead == removeTail && addHead == addTail) return;
+
+    PropagateRemove();
+    PropagateAdd();
+    if (overflow) ResetLight();
+}
+
+int GetLight(int x, int y) {
+    return light[y * GRID_W + x];
+}
@@ -1,11 +1,64 @@
 #include "game.h"
+#include <string.h>
 
-int main() {
+// Spectator mode: no simulation and no player, just draw what the server streams
+static void RunSpectator() {
+    Camera2D camera = { 0 };
+    camera.zoom = 1.0f;
+    camera.offset = (Vector2){SCREEN_WIDTH/2, SCREEN_HEIGHT/2};
+    camera.target = camera.offset;
+
+    while (!WindowShouldClose()) {
+        PollSpectator();
+        CommitSpectatorTick(); // Relights what arrived (and keeps the change list short)
+
+        // WASD pans the view
+        float pan = 300.0f * GetFrameTime();
+        if (IsKeyDown(KEY_W)) camera.target.y -= pan;
+        if (IsKeyDown(KEY_S)) camera.target.y += pan;
+        if (IsKeyDown(KEY_A)) camera.target.x -= pan;
+        if (IsKeyDown(KEY_D)) camera.target.x += pan;
+
+        BeginDrawing();
+            ClearBackground((Color){20, 20, 30, 255});
+            BeginMode2D(camera);
+                DrawWorld();
+            EndMode2D();
+            DrawText("SPECTATING", 20, 20, 20, WHITE);
+            DrawText(TextFormat("%d bytes this frame", GetReplicationBytes()), 20, 45, 10, LIGHTGRAY);
+            DrawFPS(10, SCREEN_HEIGHT - 20);
+        EndDrawing();
+        MemoryEndFrame();
+    }
+    PrintMemoryReport(stdout);
+}
+
+int main(int argc, char** argv) {
     // Initialization
     //--------------------------------------------------------------------------------------
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Mine-Noita-Craft: Physics Sandbox");
     SetTargetFPS(60);
 
+    InitReactions(); // Before the spectator too: it lights and shades by material
+    // Replication: "--serve [port]" streams this world, "--spectate [port]" watches one
+    for (int i = 1; i < argc; i++) {
+        int port = (i + 1 < argc) ? atoi(argv[i + 1]) : 0;
+        if (port <= 0) port = REPL_DEFAULT_PORT;
+
+        if (strcmp(argv[i], "--serve") == 0 && !StartReplicationServer(port)) {
+            printf("Could not start replication server on port %d\n", port);
+        }
+        if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc && !StartStatsDump(argv[i + 1])) {
+            printf("Could not open stats file %s\n", argv[i + 1]);
+        }
+        if (strcmp(argv[i], "--spectate") == 0) {
+            if (StartSpectator(port)) RunSpectator();
+            else printf("Could not listen on port %d\n", port);
+            CloseWindow();
+            return 0;
+        }
+    }
+
     InitWorld();
 
     Player player;
@@ -25,6 +78,10 @@ int main() {
     // Add trail to the player
     Vector2 trailPositions[MAX_TRAIL_LENGTH] = {0};
 
+    bool showStats = false;
+    bool showNav = false;
+    bool showMemory = false;
+
     //--------------------------------------------------------------------------------------
     // Main game loop
     while (!WindowShouldClose()) {
@@ -61,10 +118,17 @@ int main() {
         }
 
         if (IsKeyPressed(KEY_R)) InitWorld();
+        if (IsKeyPressed(KEY_F3)) showStats = !showStats;
+        if (IsKeyPressed(KEY_F4)) showNav = !showNav;
+        if (IsKeyPressed(KEY_F5)) showMemory = !showMemory;
+
+        // REWIND (hold Z): scrub back 2 ticks per frame instead of simulating
+        bool rewinding = IsKeyDown(KEY_Z) && RewindWorld(2);
+        if (rewinding) { CommitRewindTick(); CompactWorld(); }
         
         // --- PHYSICS ---
         UpdatePlayer(&player, dt);
-        UpdateWorld(); 
+        if (!rewinding) UpdateWorld(); 
         
         // --- SMOOTH CAMERA LOGIC ---
         // Instead of snapping, we slide the camera towards the player.
@@ -74,6 +138,7 @@ int main() {
         
         camera.target.x += (player.position.x - camera.target.x) * camSpeed * dt;
         camera.target.y += (player.position.y - camera.target.y) * camSpeed * dt;
+        SetSimulationFocus(camera);
 
         // --- RENDER ---
         BeginDrawing();
@@ -81,8 +146,10 @@ int main() {
 
             BeginMode2D(camera);
                 DrawWorld();
+                DrawRigidBodies();
                 Trail(&player, trailPositions);
                 DrawPlayer(&player);
+                if (showNav) DrawNavDebug(player.position, mouseWorld); // Routes from the cursor to the player
                 
                 // Draw Cursor (Centered on the brush area)
                 int drawX = (gx - brushRadius) * CELL_SIZE;
@@ -92,10 +159,15 @@ int main() {
             EndMode2D();
 
             DrawHUD(&player, &inv);
+            if (showStats) DrawStatsPanel();
+            if (showMemory) DrawMemoryPanel();
             DrawFPS(10, 10);
         EndDrawing();
+        MemoryEndFrame();
     }
 
+    StopStatsDump();
+    PrintMemoryReport(stdout);
     CloseWindow();
     return 0;
 }
\ No newline at end of file
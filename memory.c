@@ -0,0 +1,172 @@
+#define _POSIX_C_SOURCE 200112L // pthreads under -std=c99
+#include "game.h"
+#include <pthread.h>
+#include <string.h>
+
+// --- MEMORY ACCOUNTING ---
+// Engine allocations go through TagAlloc & co. with a tag saying who owns
+// them. Each block carries a small header (its size and tag), so TagFree and
+// TagRealloc know what to take off the books. Per tag we keep:
+//   live / peak   heap bytes held now, and the most ever held at once
+//   static        fixed arrays, registered once by the module that owns them
+//   rate          allocations during the last frame, and bytes allocated per
+//                 second, to spot per-frame churn
+// Buffers raylib allocates for us (image pixels) are booked by hand with
+// TrackExternal.
+//
+// Batch worlds allocate from worker threads, so the books are behind a mutex.
+// Nothing here is on a per-cell path.
+
+#define MEM_HEADER 16 // Keeps the block 16-byte aligned, like malloc
+#define MEM_MAX_STATICS 32
+
+const char* MemTagNames[MEM_TAG_COUNT] = { "world", "render", "entities", "particles", "ui" };
+
+typedef struct {
+    size_t size;
+    int tag;
+} BlockHeader;
+
+typedef struct {
+    const char* name;
+    MemTag tag;
+    size_t bytes;
+} StaticBlock;
+
+static MemoryStats tags[MEM_TAG_COUNT];
+static int pendingAllocs[MEM_TAG_COUNT];   // This frame so far
+static size_t pendingBytes[MEM_TAG_COUNT];
+static size_t windowBytes[MEM_TAG_COUNT];  // Since the rate was last updated
+static float windowSeconds = 0;
+
+static StaticBlock statics[MEM_MAX_STATICS];
+static int staticCount = 0;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Caller holds the lock
+static void Book(MemTag tag, long long bytes) {
+    MemoryStats* s = &tags[tag];
+    s->live += bytes;
+    if (s->live > s->peak) s->peak = s->live;
+    if (bytes > 0) {
+        s->allocs++;
+        s->allocated += bytes;
+        pendingAllocs[tag]++;
+        pendingBytes[tag] += bytes;
+    }
+}
+
+void* TagAlloc(MemTag tag, size_t size) {
+    BlockHeader* h = malloc(MEM_HEADER + size);
+    if (!h) return NULL;
+    h->size = size;
+    h->tag = tag;
+    pthread_mutex_lock(&lock);
+    Book(tag, (long long)size);
+    pthread_mutex_unlock(&lock);
+    return (unsigned char*)h + MEM_HEADER;
+}
+
+void* TagCalloc(MemTag tag, size_t count, size_t size) {
+    BlockHeader* h = calloc(1, MEM_HEADER + count * size);
+    if (!h) return NULL;
+    h->size = count * size;
+    h->tag = tag;
+    pthread_mutex_lock(&lock);
+    Book(tag, (long long)h->size);
+    pthread_mutex_unlock(&lock);
+    return (unsigned char*)h + MEM_HEADER;
+}
+
+// Like realloc; the block keeps the tag it was allocated with
+void* TagRealloc(MemTag tag, void* p, size_t size) {
+    if (!p) return TagAlloc(tag, size);
+    BlockHeader* h = (BlockHeader*)((unsigned char*)p - MEM_HEADER);
+    size_t old = h->size;
+    BlockHeader* moved = realloc(h, MEM_HEADER + size);
+    if (!moved) return NULL;
+    moved->size = size;
+    pthread_mutex_lock(&lock);
+    Book((MemTag)moved->tag, -(long long)old);
+    Book((MemTag)moved->tag, (long long)size);
+    pthread_mutex_unlock(&lock);
+    return (unsigned char*)moved + MEM_HEADER;
+}
+
+void TagFree(void* p) {
+    if (!p) return;
+    BlockHeader* h = (BlockHeader*)((unsigned char*)p - MEM_HEADER);
+    pthread_mutex_lock(&lock);
+    Book((MemTag)h->tag, -(long long)h->size);
+    pthread_mutex_unlock(&lock);
+    free(h);
+}
+
+// Memory someone else allocated for us: +bytes when it's created, -bytes when freed
+void TrackExternal(MemTag tag, long long bytes) {
+    pthread_mutex_lock(&lock);
+    Book(tag, bytes);
+    pthread_mutex_unlock(&lock);
+}
+
+// Fixed arrays of a module. Registering the same name again updates it.
+void TrackStatic(MemTag tag, const char* name, size_t bytes) {
+    pthread_mutex_lock(&lock);
+    int i = 0;
+    while (i < staticCount && strcmp(statics[i].name, name) != 0) i++;
+    if (i == staticCount && staticCount < MEM_MAX_STATICS) staticCount++;
+    if (i < staticCount) {
+        if (statics[i].name) tags[statics[i].tag].staticBytes -= statics[i].bytes;
+        statics[i] = (StaticBlock){ name, tag, bytes };
+        tags[tag].staticBytes += bytes;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+// Called once per frame: closes the frame's allocation counts, and updates
+// the bytes-per-second rate about once a second
+void MemoryEndFrame() {
+    pthread_mutex_lock(&lock);
+    windowSeconds += GetFrameTime();
+    for (int t = 0; t < MEM_TAG_COUNT; t++) {
+        tags[t].frameAllocs = pendingAllocs[t];
+        tags[t].frameBytes = pendingBytes[t];
+        windowBytes[t] += pendingBytes[t];
+        pendingAllocs[t] = 0;
+        pendingBytes[t] = 0;
+    }
+    if (windowSeconds >= 1.0f) {
+        for (int t = 0; t < MEM_TAG_COUNT; t++) {
+            tags[t].bytesPerSecond = windowBytes[t] / windowSeconds;
+            windowBytes[t] = 0;
+        }
+        windowSeconds = 0;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+const MemoryStats* GetMemoryStats(MemTag tag) {
+    return &tags[tag];
+}
+
+// Per tag totals, then every static array, for setting budgets
+void PrintMemoryReport(FILE* f) {
+    pthread_mutex_lock(&lock);
+    long long live = 0, peak = 0;
+    size_t fixed = 0;
+    fprintf(f, "\n--- MEMORY REPORT ---\n");
+    fprintf(f, "%-10s %12s %12s %12s %10s %14s\n", "tag", "live", "peak", "static", "allocs", "allocated");
+    for (int t = 0; t < MEM_TAG_COUNT; t++) {
+        const MemoryStats* s = &tags[t];
+        fprintf(f, "%-10s %12lld %12lld %12zu %10lld %14lld\n", MemTagNames[t], s->live, s->peak, s->staticBytes, s->allocs, s->allocated);
+        live += s->live;
+        peak += s->peak;
+        fixed += s->staticBytes;
+    }
+    fprintf(f, "%-10s %12lld %12lld %12zu   (peak is the sum of per-tag peaks)\n", "total", live, peak, fixed);
+    for (int i = 0; i < staticCount; i++) {
+        fprintf(f, "  static %-24s %-10s %10zu\n", statics[i].name, MemTagNames[statics[i].tag], statics[i].bytes);
+    }
+    pthread_mutex_unlock(&lock);
+}
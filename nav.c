@@ -0,0 +1,645 @@
+#include "game.h"
+#include <string.h>
+
+// --- PATHFINDING ---
+// Two layers, both cached per chunk:
+//
+// 1. Abstract graph (HPA*). Every chunk is a cluster. Where two chunks share
+//    a walkable opening along their border we place an entrance: one node on
+//    each side of the opening's middle (or of both ends, if it's wide), joined
+//    by a step of cost 1. Inside a chunk every pair of its nodes is joined by
+//    the walking distance between them, found with a BFS that stays in the
+//    chunk. A query searches this graph (a few thousand nodes) instead of the
+//    30,000 cells, then refines each hop with a BFS inside one chunk.
+//
+// 2. Flow fields. For a shared goal (the player) we run Dijkstra once over the
+//    abstract graph, giving every entrance its distance to the goal. A chunk's
+//    per-cell distances are filled in from its entrances the first time an
+//    agent asks for a direction there. Any number of agents then read a
+//    direction per cell with no search at all.
+//
+// Only walkability matters (see NavWalkable). CommitTick hands us the cells
+// that changed; a chunk is rebuilt on the next query only if one of its cells
+// flipped, plus its neighbour when the flipped cell is on their shared border.
+// Flow field tiles survive a rebuild unless their chunk was rebuilt or the
+// distances at its entrances moved.
+
+#define NAV_CHUNKS (CHUNKS_X * CHUNKS_Y)
+#define NAV_NODES_PER_CHUNK 32 // 4 borders x at most 8 openings
+#define NAV_NODES (NAV_CHUNKS * NAV_NODES_PER_CHUNK)
+#define NAV_START NAV_NODES      // Temporary nodes of a FindPath query
+#define NAV_GOAL (NAV_NODES + 1)
+#define NAV_WIDE_ENTRANCE 6      // Openings this wide get a node at each end
+#define NAV_HEAP_SIZE (1 << 18)
+#if CHUNK_CELLS > 256
+#error "LocalFill queues in-chunk cells as bytes"
+#endif
+
+enum { SIDE_LEFT, SIDE_RIGHT, SIDE_TOP, SIDE_BOTTOM };
+
+typedef struct {
+    int count;
+    int cell[NAV_NODES_PER_CHUNK];            // Row-major cell index
+    unsigned char side[NAV_NODES_PER_CHUNK];  // Border it sits on
+    int link[NAV_NODES_PER_CHUNK];            // Node across the border
+    unsigned short dist[NAV_NODES_PER_CHUNK][NAV_NODES_PER_CHUNK]; // Walking distance inside the chunk
+} NavChunk;
+
+typedef struct {
+    bool used;
+    int goal;                          // Row-major cell index
+    unsigned int lastUse;
+    unsigned int builtVersion;         // navVersion nodeDist was computed for
+    unsigned short nodeDist[NAV_NODES];
+    bool tileReady[NAV_CHUNKS];
+    unsigned short tile[NAV_CHUNKS][CHUNK_CELLS]; // Per-cell distance, filled on demand
+} FlowField;
+
+static bool walkable[GRID_W * GRID_H];
+static NavChunk navChunks[NAV_CHUNKS];
+static bool chunkStale[NAV_CHUNKS];
+static bool anyStale = false;
+static unsigned int navVersion = 1;          // Bumped by every rebuild
+static unsigned int chunkBuiltAt[NAV_CHUNKS]; // navVersion of its last rebuild
+
+static FlowField fields[NAV_MAX_FIELDS];
+static unsigned int fieldClock = 0;
+
+// Min-heap of (cost << 16) | node for the searches over the abstract graph
+static unsigned int heap[NAV_HEAP_SIZE];
+static int heapSize = 0;
+
+static void HeapPush(unsigned int cost, int id) {
+    if (heapSize == NAV_HEAP_SIZE) return; // Can't happen on this map size
+    unsigned int v = (cost << 16) | (unsigned int)id;
+    int i = heapSize++;
+    while (i > 0 && heap[(i - 1) / 2] > v) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = v;
+}
+
+static unsigned int HeapPop() {
+    unsigned int top = heap[0];
+    unsigned int last = heap[--heapSize];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= heapSize) break;
+        if (child + 1 < heapSize && heap[child + 1] < heap[child]) child++;
+        if (heap[child] >= last) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return top;
+}
+
+// --- CELLS AND CHUNKS ---
+
+bool NavWalkable(BlockType t) {
+    return GetDensity(t) < DENSITY_LIQUID; // Air, fire and smoke; not walls or liquids
+}
+
+static int ChunkOf(int cell) {
+    return (cell / GRID_W / CHUNK_SIZE) * CHUNKS_X + (cell % GRID_W) / CHUNK_SIZE;
+}
+
+static void ChunkBounds(int chunk, int* x0, int* y0, int* x1, int* y1) {
+    *x0 = (chunk % CHUNKS_X) * CHUNK_SIZE;
+    *y0 = (chunk / CHUNKS_X) * CHUNK_SIZE;
+    *x1 = (*x0 + CHUNK_SIZE < GRID_W) ? *x0 + CHUNK_SIZE : GRID_W;
+    *y1 = (*y0 + CHUNK_SIZE < GRID_H) ? *y0 + CHUNK_SIZE : GRID_H;
+}
+
+// Cell index inside its chunk (row-major, 0..CHUNK_CELLS-1)
+static int LocalIndex(int cell) {
+    return ((cell / GRID_W) % CHUNK_SIZE) * CHUNK_SIZE + (cell % GRID_W) % CHUNK_SIZE;
+}
+
+// Distance from the nearest seed to every cell of the chunk, walking only
+// inside it. Unreachable cells get NAV_UNREACHABLE. Steps all cost 1, so this
+// is a BFS; seeds with a head start join the queue once its front catches up.
+static void LocalFill(int chunk, const int* seedCell, const unsigned short* seedCost, int seeds, unsigned short* out) {
+    int x0, y0, x1, y1;
+    ChunkBounds(chunk, &x0, &y0, &x1, &y1);
+    for (int k = 0; k < CHUNK_CELLS; k++) out[k] = NAV_UNREACHABLE;
+
+    // Seeds sorted by cost (there are at most NAV_NODES_PER_CHUNK + 1)
+    int order[NAV_NODES_PER_CHUNK + 1];
+    for (int s = 0; s < seeds; s++) {
+        int i = s;
+        while (i > 0 && seedCost[order[i - 1]] > seedCost[s]) { order[i] = order[i - 1]; i--; }
+        order[i] = s;
+    }
+
+    unsigned char queue[CHUNK_CELLS];
+    int head = 0, tail = 0, next = 0;
+    while (head < tail || next < seeds) {
+        int local;
+        if (next < seeds && (head == tail || seedCost[order[next]] <= out[queue[head]])) {
+            int s = order[next++];
+            local = LocalIndex(seedCell[s]);
+            if (seedCost[s] >= out[local]) continue;
+            out[local] = seedCost[s];
+        } else {
+            local = queue[head++];
+        }
+
+        int lx = local % CHUNK_SIZE, ly = local / CHUNK_SIZE;
+        int cost = out[local] + 1;
+        static const int dx[4] = { -1, 1, 0, 0 }, dy[4] = { 0, 0, -1, 1 };
+        for (int d = 0; d < 4; d++) {
+            int nx = x0 + lx + dx[d], ny = y0 + ly + dy[d];
+            if (nx < x0 || nx >= x1 || ny < y0 || ny >= y1 || !walkable[ny * GRID_W + nx]) continue;
+            int n = (ny - y0) * CHUNK_SIZE + (nx - x0);
+            if (cost < out[n]) {
+                out[n] = (unsigned short)cost;
+                queue[tail++] = (unsigned char)n;
+            }
+        }
+    }
+}
+
+// --- ABSTRACT GRAPH ---
+
+static void AddNode(NavChunk* nc, int cell, int side) {
+    nc->cell[nc->count] = cell;
+    nc->side[nc->count] = (unsigned char)side;
+    nc->link[nc->count] = -1;
+    nc->count++;
+}
+
+// Entrances along one border. (x, y) walks the cells on our side, step is the
+// offset to the next one, across the offset to the matching cell next door.
+static void ScanBorder(NavChunk* nc, int x, int y, int stepX, int stepY, int length, int acrossX, int acrossY, int side) {
+    int runStart = -1;
+    for (int i = 0; i <= length; i++) {
+        bool open = false;
+        if (i < length) {
+            int cx = x + i * stepX, cy = y + i * stepY;
+            open = walkable[cy * GRID_W + cx] && walkable[(cy + acrossY) * GRID_W + cx + acrossX];
+        }
+        if (open && runStart < 0) runStart = i;
+        if (open || runStart < 0) continue;
+
+        int runEnd = i - 1;
+        if (runEnd - runStart + 1 >= NAV_WIDE_ENTRANCE) {
+            AddNode(nc, (y + runStart * stepY) * GRID_W + x + runStart * stepX, side);
+            AddNode(nc, (y + runEnd * stepY) * GRID_W + x + runEnd * stepX, side);
+        } else {
+            int mid = (runStart + runEnd) / 2;
+            AddNode(nc, (y + mid * stepY) * GRID_W + x + mid * stepX, side);
+        }
+        runStart = -1;
+    }
+}
+
+static void BuildNodes(int chunk) {
+    NavChunk* nc = &navChunks[chunk];
+    int x0, y0, x1, y1;
+    ChunkBounds(chunk, &x0, &y0, &x1, &y1);
+    nc->count = 0;
+    if (x0 > 0)      ScanBorder(nc, x0, y0, 0, 1, y1 - y0, -1, 0, SIDE_LEFT);
+    if (x1 < GRID_W) ScanBorder(nc, x1 - 1, y0, 0, 1, y1 - y0, 1, 0, SIDE_RIGHT);
+    if (y0 > 0)      ScanBorder(nc, x0, y0, 1, 0, x1 - x0, 0, -1, SIDE_TOP);
+    if (y1 < GRID_H) ScanBorder(nc, x0, y1 - 1, 1, 0, x1 - x0, 0, 1, SIDE_BOTTOM);
+}
+
+// Both sides of a border scan the same openings, so the node across from ours
+// is the one at the neighbouring cell on the opposite side.
+static void LinkNodes(int chunk) {
+    static const int acrossCell[4] = { -1, 1, -GRID_W, GRID_W };
+    static const int acrossChunk[4] = { -1, 1, -CHUNKS_X, CHUNKS_X };
+    NavChunk* nc = &navChunks[chunk];
+    for (int k = 0; k < nc->count; k++) {
+        int other = chunk + acrossChunk[nc->side[k]];
+        int target = nc->cell[k] + acrossCell[nc->side[k]];
+        NavChunk* on = &navChunks[other];
+        nc->link[k] = -1;
+        for (int j = 0; j < on->count; j++) {
+            if (on->cell[j] == target && on->side[j] == (nc->side[k] ^ 1)) {
+                nc->link[k] = other * NAV_NODES_PER_CHUNK + j;
+                break;
+            }
+        }
+    }
+}
+
+static void BuildDistances(int chunk) {
+    NavChunk* nc = &navChunks[chunk];
+    unsigned short fill[CHUNK_CELLS];
+    unsigned short zero = 0;
+    for (int k = 0; k < nc->count; k++) {
+        LocalFill(chunk, &nc->cell[k], &zero, 1, fill);
+        for (int j = 0; j < nc->count; j++) nc->dist[k][j] = fill[LocalIndex(nc->cell[j])];
+    }
+}
+
+// Rebuilds whatever CommitTick marked stale. Runs lazily before any query.
+static void NavRefresh() {
+    if (!anyStale) return;
+    anyStale = false;
+    navVersion++;
+
+    for (int c = 0; c < NAV_CHUNKS; c++) {
+        if (!chunkStale[c]) continue;
+        BuildNodes(c);
+        chunkBuiltAt[c] = navVersion;
+        LiveStats.navRebuilt++;
+    }
+    // Node numbers of a rebuilt chunk may have shifted: relink it and its neighbours
+    for (int c = 0; c < NAV_CHUNKS; c++) {
+        int cx = c % CHUNKS_X, cy = c / CHUNKS_X;
+        bool near = chunkStale[c] || (cx > 0 && chunkStale[c - 1]) || (cx < CHUNKS_X - 1 && chunkStale[c + 1]) ||
+                    (cy > 0 && chunkStale[c - CHUNKS_X]) || (cy < CHUNKS_Y - 1 && chunkStale[c + CHUNKS_X]);
+        if (near) LinkNodes(c);
+    }
+    for (int c = 0; c < NAV_CHUNKS; c++) {
+        if (!chunkStale[c]) continue;
+        BuildDistances(c);
+        chunkStale[c] = false;
+    }
+}
+
+static void MarkStale(int cell) {
+    int x = cell % GRID_W, y = cell / GRID_W;
+    int chunk = ChunkOf(cell);
+    chunkStale[chunk] = true;
+    // A border cell also decides the openings of the chunk next to it
+    if (x % CHUNK_SIZE == 0 && x > 0) chunkStale[chunk - 1] = true;
+    if (x % CHUNK_SIZE == CHUNK_SIZE - 1 && x < GRID_W - 1) chunkStale[chunk + 1] = true;
+    if (y % CHUNK_SIZE == 0 && y > 0) chunkStale[chunk - CHUNKS_X] = true;
+    if (y % CHUNK_SIZE == CHUNK_SIZE - 1 && y < GRID_H - 1) chunkStale[chunk + CHUNKS_X] = true;
+    anyStale = true;
+}
+
+static void TrackNavMemory(); // Needs the search arrays below
+
+// New map: everything is rebuilt and all flow fields are dropped
+void ResetNav() {
+    TrackNavMemory();
+    for (int i = 0; i < GRID_W * GRID_H; i++) walkable[i] = NavWalkable(GetCellType(i % GRID_W, i / GRID_W));
+    for (int c = 0; c < NAV_CHUNKS; c++) chunkStale[c] = true;
+    anyStale = true;
+    for (int f = 0; f < NAV_MAX_FIELDS; f++) fields[f].used = false;
+}
+
+// Called once per committed tick with every cell that may have changed
+void NavCommitTick(const int* changed, int count) {
+    for (int i = 0; i < count; i++) {
+        int cell = changed[i];
+        bool w = NavWalkable(GetCellType(cell % GRID_W, cell / GRID_W));
+        if (w == walkable[cell]) continue;
+        walkable[cell] = w;
+        MarkStale(cell);
+    }
+}
+
+// --- PATH QUERIES ---
+
+// Connected regions of the abstract graph, so a query towards a sealed-off
+// goal fails at once instead of searching everything reachable first.
+static int nodeRegion[NAV_NODES];
+static unsigned int regionsVersion = 0;
+
+static void BuildRegions() {
+    if (regionsVersion == navVersion) return;
+    regionsVersion = navVersion;
+    static int stack[NAV_NODES];
+    for (int n = 0; n < NAV_NODES; n++) nodeRegion[n] = -1;
+    for (int n = 0; n < NAV_NODES; n++) {
+        if (nodeRegion[n] >= 0 || n % NAV_NODES_PER_CHUNK >= navChunks[n / NAV_NODES_PER_CHUNK].count) continue;
+        int top = 0;
+        stack[top++] = n;
+        nodeRegion[n] = n;
+        while (top > 0) {
+            int node = stack[--top];
+            int chunk = node / NAV_NODES_PER_CHUNK, k = node % NAV_NODES_PER_CHUNK;
+            NavChunk* nc = &navChunks[chunk];
+            if (nc->link[k] >= 0 && nodeRegion[nc->link[k]] < 0) {
+                nodeRegion[nc->link[k]] = n;
+                stack[top++] = nc->link[k];
+            }
+            for (int j = 0; j < nc->count; j++) {
+                int other = chunk * NAV_NODES_PER_CHUNK + j;
+                if (nc->dist[k][j] != NAV_UNREACHABLE && nodeRegion[other] < 0) {
+                    nodeRegion[other] = n;
+                    stack[top++] = other;
+                }
+            }
+        }
+    }
+}
+
+// True if some entrance the start can walk to shares a region with one the goal can
+static bool RegionsMeet(int startChunk, const unsigned short* fromStart, int goalChunk, const unsigned short* toGoal) {
+    NavChunk* sc = &navChunks[startChunk];
+    NavChunk* gc = &navChunks[goalChunk];
+    for (int k = 0; k < sc->count; k++) {
+        if (fromStart[LocalIndex(sc->cell[k])] == NAV_UNREACHABLE) continue;
+        int region = nodeRegion[startChunk * NAV_NODES_PER_CHUNK + k];
+        for (int j = 0; j < gc->count; j++) {
+            if (toGoal[LocalIndex(gc->cell[j])] != NAV_UNREACHABLE && nodeRegion[goalChunk * NAV_NODES_PER_CHUNK + j] == region) return true;
+        }
+    }
+    return false;
+}
+
+static unsigned short nodeCost[NAV_NODES + 2];
+static int nodeParent[NAV_NODES + 2];
+static unsigned int nodeSeen[NAV_NODES + 2]; // == searchStamp: nodeCost is valid this search
+static unsigned int nodeDone[NAV_NODES + 2]; // == searchStamp: already expanded
+static unsigned int searchStamp = 0;
+
+static void TrackNavMemory() {
+    TrackStatic(MEM_WORLD, "nav graph", sizeof(walkable) + sizeof(navChunks) + sizeof(chunkStale) + sizeof(chunkBuiltAt) + sizeof(nodeRegion));
+    TrackStatic(MEM_WORLD, "nav flow fields", sizeof(fields));
+    TrackStatic(MEM_WORLD, "nav search", sizeof(heap) + sizeof(nodeCost) + sizeof(nodeParent) + sizeof(nodeSeen) + sizeof(nodeDone));
+}
+
+static int NodeCell(int node) {
+    return navChunks[node / NAV_NODES_PER_CHUNK].cell[node % NAV_NODES_PER_CHUNK];
+}
+
+static int Manhattan(int a, int b) {
+    return abs(a % GRID_W - b % GRID_W) + abs(a / GRID_W - b / GRID_W);
+}
+
+static void Relax(int node, int cost, int parent, int heuristic) {
+    if (cost >= NAV_UNREACHABLE) return;
+    if (nodeSeen[node] == searchStamp && nodeCost[node] <= cost) return;
+    nodeSeen[node] = searchStamp;
+    nodeCost[node] = (unsigned short)cost;
+    nodeParent[node] = parent;
+    HeapPush((unsigned int)(cost + heuristic), node);
+}
+
+// Appends the cells from a to b (a excluded), walking inside their chunk
+static int RefineHop(int a, int b, int* path, int len, int maxLen) {
+    if (Manhattan(a, b) == 1) {
+        if (len < maxLen) path[len++] = b;
+        return len;
+    }
+    int chunk = ChunkOf(b);
+    unsigned short toB[CHUNK_CELLS];
+    unsigned short zero = 0;
+    LocalFill(chunk, &b, &zero, 1, toB);
+
+    int x0, y0, x1, y1;
+    ChunkBounds(chunk, &x0, &y0, &x1, &y1);
+    int cell = a;
+    while (cell != b && len < maxLen) {
+        // Step to the neighbour closest to b
+        int x = cell % GRID_W, y = cell / GRID_W;
+        int best = -1, bestDist = toB[LocalIndex(cell)];
+        int around[4] = { cell - 1, cell + 1, cell - GRID_W, cell + GRID_W };
+        bool inside[4] = { x > x0, x < x1 - 1, y > y0, y < y1 - 1 };
+        for (int d = 0; d < 4; d++) {
+            if (inside[d] && toB[LocalIndex(around[d])] < bestDist) {
+                best = around[d];
+                bestDist = toB[LocalIndex(best)];
+            }
+        }
+        if (best < 0) break; // Only if the graph is stale, which NavRefresh prevents
+        path[len++] = best;
+        cell = best;
+    }
+    return len;
+}
+
+// Shortest walkable route from (sx, sy) to (gx, gy), as row-major cell
+// indices from start to goal. The two ends themselves may be blocked (a mob
+// wading in water, a player standing in it). Returns the number of cells written (cut off at
+// maxLen), or -1 if the goal can't be reached.
+int FindPath(int sx, int sy, int gx, int gy, int* path, int maxLen) {
+    if (sx < 0 || sy < 0 || sx >= GRID_W || sy >= GRID_H || gx < 0 || gy < 0 || gx >= GRID_W || gy >= GRID_H) return -1;
+    int start = sy * GRID_W + sx, goal = gy * GRID_W + gx;
+    if (maxLen <= 0) return -1;
+    NavRefresh();
+
+    int startChunk = ChunkOf(start), goalChunk = ChunkOf(goal);
+    unsigned short fromStart[CHUNK_CELLS], toGoal[CHUNK_CELLS];
+    unsigned short zero = 0;
+    LocalFill(startChunk, &start, &zero, 1, fromStart);
+    LocalFill(goalChunk, &goal, &zero, 1, toGoal);
+
+    path[0] = start;
+    if (startChunk == goalChunk && fromStart[LocalIndex(goal)] != NAV_UNREACHABLE) {
+        return RefineHop(start, goal, path, 1, maxLen);
+    }
+
+    BuildRegions();
+    if (!RegionsMeet(startChunk, fromStart, goalChunk, toGoal)) return -1;
+
+    // A* over the entrances, with the start and goal as two extra nodes
+    searchStamp++;
+    heapSize = 0;
+    Relax(NAV_START, 0, -1, Manhattan(start, goal));
+    bool found = false;
+    while (heapSize > 0) {
+        int node = HeapPop() & 0xFFFF;
+        if (node == NAV_GOAL) { found = true; break; }
+        if (nodeDone[node] == searchStamp) continue;
+        nodeDone[node] = searchStamp;
+        int cost = nodeCost[node];
+
+        if (node == NAV_START) {
+            NavChunk* nc = &navChunks[startChunk];
+            for (int k = 0; k < nc->count; k++) {
+                int n = startChunk * NAV_NODES_PER_CHUNK + k;
+                Relax(n, fromStart[LocalIndex(nc->cell[k])], node, Manhattan(nc->cell[k], goal));
+            }
+            continue;
+        }
+
+        int chunk = node / NAV_NODES_PER_CHUNK, k = node % NAV_NODES_PER_CHUNK;
+        NavChunk* nc = &navChunks[chunk];
+        if (chunk == goalChunk) Relax(NAV_GOAL, cost + toGoal[LocalIndex(nc->cell[k])], node, 0);
+        if (nc->link[k] >= 0) Relax(nc->link[k], cost + 1, node, Manhattan(NodeCell(nc->link[k]), goal));
+        for (int j = 0; j < nc->count; j++) {
+            if (j == k || nc->dist[k][j] == NAV_UNREACHABLE) continue;
+            Relax(chunk * NAV_NODES_PER_CHUNK + j, cost + nc->dist[k][j], node, Manhattan(nc->cell[j], goal));
+        }
+    }
+    if (!found) return -1;
+
+    // Walk the parents back, then refine each hop into cells
+    static int hops[NAV_NODES + 2];
+    int hopCount = 0;
+    for (int node = nodeParent[NAV_GOAL]; node != NAV_START; node = nodeParent[node]) hops[hopCount++] = NodeCell(node);
+
+    int len = 1, at = start;
+    for (int h = hopCount - 1; h >= 0 && len < maxLen; h--) {
+        len = RefineHop(at, hops[h], path, len, maxLen);
+        at = hops[h];
+    }
+    if (len < maxLen) len = RefineHop(at, goal, path, len, maxLen);
+    return len;
+}
+
+// --- FLOW FIELDS ---
+
+// Distance from every entrance to the goal (the graph is undirected)
+static void BuildNodeDistances(FlowField* f) {
+    for (int n = 0; n < NAV_NODES; n++) f->nodeDist[n] = NAV_UNREACHABLE;
+
+    int goalChunk = ChunkOf(f->goal);
+    unsigned short toGoal[CHUNK_CELLS];
+    unsigned short zero = 0;
+    LocalFill(goalChunk, &f->goal, &zero, 1, toGoal);
+
+    heapSize = 0;
+    NavChunk* gc = &navChunks[goalChunk];
+    for (int k = 0; k < gc->count; k++) {
+        int n = goalChunk * NAV_NODES_PER_CHUNK + k;
+        f->nodeDist[n] = toGoal[LocalIndex(gc->cell[k])];
+        if (f->nodeDist[n] != NAV_UNREACHABLE) HeapPush(f->nodeDist[n], n);
+    }
+    while (heapSize > 0) {
+        unsigned int top = HeapPop();
+        int node = top & 0xFFFF, cost = top >> 16;
+        if (cost > f->nodeDist[node]) continue;
+        int chunk = node / NAV_NODES_PER_CHUNK, k = node % NAV_NODES_PER_CHUNK;
+        NavChunk* nc = &navChunks[chunk];
+        if (nc->link[k] >= 0 && cost + 1 < f->nodeDist[nc->link[k]]) {
+            f->nodeDist[nc->link[k]] = (unsigned short)(cost + 1);
+            HeapPush(cost + 1, nc->link[k]);
+        }
+        for (int j = 0; j < nc->count; j++) {
+            int next = cost + nc->dist[k][j];
+            int n = chunk * NAV_NODES_PER_CHUNK + j;
+            if (nc->dist[k][j] != NAV_UNREACHABLE && next < f->nodeDist[n]) {
+                f->nodeDist[n] = (unsigned short)next;
+                HeapPush(next, n);
+            }
+        }
+    }
+}
+
+// Brings a field up to date with the graph, keeping the tiles that didn't move
+static void RefreshField(FlowField* f) {
+    NavRefresh();
+    if (f->builtVersion == navVersion) return;
+
+    static unsigned short oldDist[NAV_NODES];
+    memcpy(oldDist, f->nodeDist, sizeof(oldDist));
+    BuildNodeDistances(f);
+
+    for (int c = 0; c < NAV_CHUNKS; c++) {
+        if (!f->tileReady[c]) continue;
+        bool same = chunkBuiltAt[c] <= f->builtVersion;
+        for (int k = 0; same && k < navChunks[c].count; k++) {
+            int n = c * NAV_NODES_PER_CHUNK + k;
+            same = oldDist[n] == f->nodeDist[n];
+        }
+        f->tileReady[c] = same;
+    }
+    f->builtVersion = navVersion;
+}
+
+static const unsigned short* FieldTile(FlowField* f, int chunk) {
+    if (f->tileReady[chunk]) return f->tile[chunk];
+
+    NavChunk* nc = &navChunks[chunk];
+    int seedCell[NAV_NODES_PER_CHUNK + 1];
+    unsigned short seedCost[NAV_NODES_PER_CHUNK + 1];
+    int seeds = 0;
+    for (int k = 0; k < nc->count; k++) {
+        seedCell[seeds] = nc->cell[k];
+        seedCost[seeds] = f->nodeDist[chunk * NAV_NODES_PER_CHUNK + k];
+        if (seedCost[seeds] != NAV_UNREACHABLE) seeds++;
+    }
+    if (ChunkOf(f->goal) == chunk) {
+        seedCell[seeds] = f->goal;
+        seedCost[seeds] = 0;
+        seeds++;
+    }
+    LocalFill(chunk, seedCell, seedCost, seeds, f->tile[chunk]);
+    f->tileReady[chunk] = true;
+    return f->tile[chunk];
+}
+
+// A flow field towards (gx, gy). Agents heading for the same cell share one;
+// the least recently used field is recycled when all NAV_MAX_FIELDS are taken.
+int GetFlowField(int gx, int gy) {
+    gx = (gx < 0) ? 0 : (gx >= GRID_W) ? GRID_W - 1 : gx;
+    gy = (gy < 0) ? 0 : (gy >= GRID_H) ? GRID_H - 1 : gy;
+    int goal = gy * GRID_W + gx;
+    fieldClock++;
+
+    int pick = 0;
+    for (int i = 0; i < NAV_MAX_FIELDS; i++) {
+        if (fields[i].used && fields[i].goal == goal) {
+            fields[i].lastUse = fieldClock;
+            return i;
+        }
+        if (!fields[i].used || (fields[pick].used && fields[i].lastUse < fields[pick].lastUse)) pick = i;
+    }
+
+    FlowField* f = &fields[pick];
+    f->used = true;
+    f->goal = goal;
+    f->lastUse = fieldClock;
+    f->builtVersion = 0;
+    memset(f->tileReady, 0, sizeof(f->tileReady));
+    return pick;
+}
+
+// Cells to walk from (x, y) to the field's goal, NAV_UNREACHABLE if there's no way
+int GetFlowDistance(int field, int x, int y) {
+    if (x < 0 || y < 0 || x >= GRID_W || y >= GRID_H) return NAV_UNREACHABLE;
+    FlowField* f = &fields[field];
+    RefreshField(f);
+    int cell = y * GRID_W + x;
+    return FieldTile(f, ChunkOf(cell))[LocalIndex(cell)];
+}
+
+// Unit direction to step in from (x, y): towards the neighbour closest to the
+// goal (diagonals only when both sides are open). Zero at the goal or when stuck.
+Vector2 GetFlowDirection(int field, int x, int y) {
+    int here = GetFlowDistance(field, x, y);
+    if (here == 0 || here == NAV_UNREACHABLE) return (Vector2){ 0, 0 };
+
+    int bestX = 0, bestY = 0, best = here;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (dx == 0 && dy == 0) continue;
+            int nx = x + dx, ny = y + dy;
+            if (nx < 0 || ny < 0 || nx >= GRID_W || ny >= GRID_H) continue;
+            if (dx != 0 && dy != 0 && (!walkable[y * GRID_W + nx] || !walkable[ny * GRID_W + x])) continue;
+            int d = GetFlowDistance(field, nx, ny);
+            if (d < best) {
+                best = d;
+                bestX = dx;
+                bestY = dy;
+            }
+        }
+    }
+    return Vector2Normalize((Vector2){ (float)bestX, (float)bestY });
+}
+
+// --- DEBUG VIEW (F4) ---
+// Flow arrows towards `goal` and the FindPath route from `from`, in world space
+void DrawNavDebug(Vector2 goal, Vector2 from) {
+    int gx = (int)(goal.x / CELL_SIZE), gy = (int)(goal.y / CELL_SIZE);
+    int field = GetFlowField(gx, gy);
+    for (int y = 2; y < GRID_H; y += 6) {
+        for (int x = 2; x < GRID_W; x += 6) {
+            Vector2 dir = GetFlowDirection(field, x, y);
+            if (dir.x == 0 && dir.y == 0) continue;
+            Vector2 p = { (x + 0.5f) * CELL_SIZE, (y + 0.5f) * CELL_SIZE };
+            DrawLineV(p, Vector2Add(p, Vector2Scale(dir, CELL_SIZE * 3.0f)), Fade(SKYBLUE, 0.6f));
+            DrawCircleV(p, 1.0f, Fade(SKYBLUE, 0.6f));
+        }
+    }
+
+    static int path[GRID_W * GRID_H];
+    int len = FindPath((int)(from.x / CELL_SIZE), (int)(from.y / CELL_SIZE), gx, gy, path, GRID_W * GRID_H);
+    for (int i = 1; i < len; i++) {
+        Vector2 a = { (path[i - 1] % GRID_W + 0.5f) * CELL_SIZE, (path[i - 1] / GRID_W + 0.5f) * CELL_SIZE };
+        Vector2 b = { (path[i] % GRID_W + 0.5f) * CELL_SIZE, (path[i] / GRID_W + 0.5f) * CELL_SIZE };
+        DrawLineEx(a, b, 2.0f, YELLOW);
+    }
+}
@@ -1,13 +1,138 @@
 #include "game.h"
+#include <string.h>
+
+// --- GRID LAYOUT ---
+// The grid is stored as CHUNK_SIZE x CHUNK_SIZE tiles (one per LOD chunk),
+// and the cells inside a tile in Z-order (Morton order: the bits of x and y
+// interleaved). A cell's 8 neighbours then mostly sit in the same tile
+// instead of a whole row (GRID_W cells) apart, and every chunk is one unit
+// of storage that chunks.c can compress on its own.
+#define TILE_BITS 4
+#if (1 << TILE_BITS) != CHUNK_SIZE
+#error "Tiles are chunks: TILE_BITS must be log2(CHUNK_SIZE)"
+#endif
+#define TILE_CELLS CHUNK_CELLS
+#define MORTON_X 0x55 // Bits of the in-tile index that hold x
+#define MORTON_Y 0xAA // ...and y
+
+// 0..15 with its bits spread out to the even positions (y uses it shifted by 1)
+static const unsigned char mortonSpread[CHUNK_SIZE] = { 0, 1, 4, 5, 16, 17, 20, 21, 64, 65, 68, 69, 80, 81, 84, 85 };
+
+static inline int CellIndex(int x, int y) {
+    int tile = (y >> TILE_BITS) * CHUNKS_X + (x >> TILE_BITS);
+    return (tile << (2 * TILE_BITS)) | mortonSpread[x & (CHUNK_SIZE - 1)] | (mortonSpread[y & (CHUNK_SIZE - 1)] << 1);
+}
 
-// The World Grid (Double Buffered)
-static Cell grid[GRID_H][GRID_W];
-static Cell nextGrid[GRID_H][GRID_W]; 
+// Index of (x+dx, y+dy) from idx = CellIndex(x, y), for steps of at most 1.
+// Inside a tile this is a masked add on the Morton code (the carry skips
+// over the other axis' bits); only steps across a tile edge start over.
+static inline int NeighbourIndex(int idx, int x, int y, int dx, int dy) {
+    int lx = (x & (CHUNK_SIZE - 1)) + dx, ly = (y & (CHUNK_SIZE - 1)) + dy;
+    if ((unsigned)lx >= CHUNK_SIZE || (unsigned)ly >= CHUNK_SIZE) return CellIndex(x + dx, y + dy);
+    if (dx > 0) idx = (idx & ~MORTON_X) | (((idx | MORTON_Y) + 1) & MORTON_X);
+    else if (dx < 0) idx = (idx & ~MORTON_X) | (((idx & MORTON_X) - 1) & MORTON_X);
+    if (dy > 0) idx = (idx & ~MORTON_Y) | (((idx | MORTON_X) + 2) & MORTON_Y);
+    else if (dy < 0) idx = (idx & ~MORTON_Y) | (((idx & MORTON_Y) - 2) & MORTON_Y);
+    return idx;
+}
 
-// Generate noise colors for texture
-Color GetBlockColor(BlockType t) {
-    // Makes block not look too dull by tweaking the element's color
-    int v = GetRandomValue(-15, 15);
+// The main world: the one the player walks in, and the only one lighting,
+// pathfinding, history etc. follow. Every other World is a headless copy of
+// the same simulation (see world.c). Zero is a valid empty world, apart from
+// these pointers.
+static World mainWorld = {
+    .grid = mainWorld.storeA,
+    .nextGrid = mainWorld.storeB,
+    .simView = { GRID_W / 2.0f, GRID_H / 2.0f, 0, 0 },
+    .rng = 1,
+    .stats = &LiveStats,
+};
+
+// Same as ChunkGet / ChunkSet, with the common cases inlined for the hot loops
+static inline CellState ReadState(const Chunk* store, int idx) {
+    const Chunk* c = &store[idx >> (2 * TILE_BITS)];
+    int k = idx & (TILE_CELLS - 1);
+    switch (c->kind) {
+        case CHUNK_UNIFORM: return c->palette[0];
+        case CHUNK_FULL: return c->cells[k];
+        default: {
+            int bit = k * c->bits;
+            return c->palette[(c->indices[bit >> 3] >> (bit & 7)) & ((1 << c->bits) - 1)];
+        }
+    }
+}
+
+static inline void WriteState(World* w, Chunk* store, int idx, CellState s) {
+    Chunk* c = &store[idx >> (2 * TILE_BITS)];
+    if (c->kind == CHUNK_FULL) {
+        c->cells[idx & (TILE_CELLS - 1)] = s;
+        c->dirty = true;
+        return;
+    }
+    ChunkSet(&w->pool, c, idx & (TILE_CELLS - 1), s);
+}
+
+// Cells touched since the last tick was committed (edits + simulation).
+// Consumers like the rewind history only look at these, never the whole grid.
+static void MarkChanged(World* w, int x, int y) {
+    if (w->changedFlag[y][x]) return;
+    w->changedFlag[y][x] = true;
+    w->changedCells[w->changedCount++] = y * GRID_W + x;
+}
+
+static void ClearChanged(World* w) {
+    for (int i = 0; i < w->changedCount; i++) {
+        w->changedFlag[w->changedCells[i] / GRID_W][w->changedCells[i] % GRID_W] = false;
+    }
+    w->changedCount = 0;
+}
+
+void CommitTick() {
+    World* w = &mainWorld;
+    RigidCommitTick(w->changedCells, w->changedCount); // First: pieces it detaches are changes too
+    LightCommitTick(w->changedCells, w->changedCount);
+    NavCommitTick(w->changedCells, w->changedCount);
+    SurfaceCommitTick(w->changedCells, w->changedCount);
+    HistoryCommitTick(w->changedCells, w->changedCount);
+    ReplicationServerTick(w->changedCells, w->changedCount);
+    ClearChanged(w);
+}
+
+// A spectator never simulates: the streamed cells only need relighting and
+// new surfaces. No pieces are detached and no history is kept.
+void CommitSpectatorTick() {
+    World* w = &mainWorld;
+    LightCommitTick(w->changedCells, w->changedCount);
+    SurfaceCommitTick(w->changedCells, w->changedCount);
+    ClearChanged(w);
+}
+
+// A rewind scrub rewrites cells without simulating. Integrity, lighting,
+// paths and surfaces follow the restored cells; history and replication do
+// not (the history is what we restored from).
+void CommitRewindTick() {
+    World* w = &mainWorld;
+    RigidCommitTick(w->changedCells, w->changedCount);
+    LightCommitTick(w->changedCells, w->changedCount);
+    NavCommitTick(w->changedCells, w->changedCount);
+    SurfaceCommitTick(w->changedCells, w->changedCount);
+    ClearChanged(w);
+}
+
+// Per-world random numbers (raylib's GetRandomValue is one shared rand())
+static unsigned int NextRandom(World* w) {
+    unsigned int x = w->rng;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return w->rng = x;
+}
+
+// min..max inclusive, like GetRandomValue
+static int RandomRange(World* w, int min, int max) {
+    return min + (int)(NextRandom(w) % (unsigned int)(max - min + 1));
+}
+
+// Base color of a block, shifted by v (-15..15)
+static Color ShadeBlock(BlockType t, int v) {
     switch(t) {
         case BLOCK_STONE: return (Color){100+v, 100+v, 100+v, 255};
         case BLOCK_DIRT:  return (Color){120+v, 90+v, 40+v, 255};
@@ -15,12 +140,37 @@ Color GetBlockColor(BlockType t) {
         case BLOCK_WATER: return (Color){0, 150+v, 250, 200}; // Transparent Blue
         case BLOCK_LAVA:  return (Color){255, 100+v, 0, 255};
         case BLOCK_WOOD:  return (Color){139+v, 69+v, 19+v, 255};
-        case BLOCK_FIRE:  return (Color){255, GetRandomValue(150,250), 0, 255}; // Flicker
+        case BLOCK_FIRE:  return (Color){255, 200+v*3, 0, 255}; // Flicker
         case BLOCK_SMOKE: return (Color){50+v, 50+v, 50+v, 150};
         default: return BLANK;
     }
 }
 
+// Generate noise colors for texture
+Color GetBlockColor(BlockType t) {
+    // Makes block not look too dull by tweaking the element's color
+    return ShadeBlock(t, GetRandomValue(-15, 15));
+}
+
+// The same noise, but always the same for a given cell. The grid doesn't
+// store colors (see chunks.c), so they have to come out identical every time.
+Color GetBlockColorAt(BlockType t, int x, int y) {
+    unsigned int h = (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u ^ (unsigned int)t * 83492791u;
+    h ^= h >> 13; h *= 0x5bd1e995u; h ^= h >> 15;
+    return ShadeBlock(t, (int)(h % 31) - 15);
+}
+
+static Cell UnpackCell(CellState s, int x, int y) {
+    Cell c;
+    c.type = STATE_TYPE(s);
+    c.floor = STATE_FLOOR(s);
+    c.life = STATE_LIFE(s);
+    c.active = STATE_ACTIVE(s);
+    c.color = GetBlockColorAt(c.type, x, y);
+    c.floorColor = GetBlockColorAt(c.floor, x, y);
+    return c;
+}
+
 // --- PHYSICS HELPER: DENSITY ---
 int GetDensity(BlockType t) {
     switch(t) {
@@ -40,10 +190,13 @@ int GetDensity(BlockType t) {
     }
 }
 
-void InitWorld() {
+static void CompactGrid(World* w); // See CELLULAR AUTOMATA ENGINE
+
+// Perlin noise terrain: stone and sand patches, ponds, a dirt floor everywhere
+static void GenerateTerrain(World* w) {
     // 1. Generate a Perlin noise map using Raylib
     // Parameters: Width, Height, OffsetX, OffsetY, Scale
-    // We use GetRandomValue for offsets so the map is different every time you press 'R'
+    // Random offsets so the map is different every time you press 'R'
     float freq = 0.2f; // frequency (noise scale)
         // Lower Scale (e.g., 1.0f): Zooms in. The blobs of Sand and Stone become huge.
         // Higher Scale (e.g., 10.0f): Zooms out. The terrain looks like scattered noise or static.
@@ -52,11 +205,16 @@ void InitWorld() {
         // 4.0f = Medium Features: Distinct patches (Current setting).
         // 1.0f = Large Features: Massive continents of stone or sand.
         // 0.2f = Huge Features: The entire screen might be just one material.
-    Image noiseMap = GenImagePerlinNoise(GRID_W, GRID_H, GetRandomValue(0, 1000), GetRandomValue(0, 1000), freq);
+    Image noiseMap = GenImagePerlinNoise(GRID_W, GRID_H, RandomRange(w, 0, 1000), RandomRange(w, 0, 1000), freq);
     
     // 2. Load the pixel data so we can read values
     Color* pixels = LoadImageColors(noiseMap);
+    long long imageBytes = (long long)GRID_W * GRID_H * sizeof(Color); // Each of the two (raylib allocates them)
+    TrackExternal(MEM_WORLD, imageBytes);
+    TrackExternal(MEM_WORLD, imageBytes);
 
+    // Start from empty chunks so the old map's storage is released
+    for (int i = 0; i < CHUNK_COUNT; i++) ChunkFill(&w->pool, &w->grid[i], MAKE_STATE(BLOCK_AIR, BLOCK_DIRT, 0, true));
     for(int y=0; y < GRID_H; y++){
         for(int x=0; x < GRID_W; x++){
             // 3. Read the noise value (0.0 to 1.0)
@@ -65,9 +223,8 @@ void InitWorld() {
 
             // SETUP FLOOR (Background)
             // The floor is always DIRT (or you can add noise for Stone floors)
-            grid[y][x].floor = BLOCK_DIRT;
-            // Generate the color ONCE and save it.
-            grid[y][x].floorColor = GetBlockColor(BLOCK_DIRT);
+            // Its color comes from GetBlockColorAt, so it never flickers.
+            BlockType floorType = BLOCK_DIRT;
 
             // SETUP OBJECTS (Foreground)
             // By default, the foreground is AIR (Empty, so we see the floor)
@@ -79,19 +236,46 @@ void InitWorld() {
             else if (noiseVal > 0.65f) fgType = BLOCK_WATER;       // Sandy patches
             
             // 5. Apply to Grid
-            grid[y][x].type = fgType;
-            grid[y][x].active = true;
-            grid[y][x].color = GetBlockColor(fgType);
-            // grid[y][x].life = 0;
+            int life = (fgType == BLOCK_WATER) ? 5 : 0;
+            WriteState(w, w->grid, CellIndex(x, y), MAKE_STATE(fgType, floorType, life, true));
 
-            if (fgType == BLOCK_WATER) grid[y][x].life = 5;
-            else grid[y][x].life = 0;
+            MarkChanged(w, x, y);
         }
     }
+    CompactGrid(w);
 
     // 6. Cleanup memory
     UnloadImageColors(pixels);
     UnloadImage(noiseMap);
+    TrackExternal(MEM_WORLD, -imageBytes);
+    TrackExternal(MEM_WORLD, -imageBytes);
+}
+
+void InitWorld() {
+    TrackStatic(MEM_WORLD, "main world", sizeof(mainWorld));
+    mainWorld.rng = (unsigned int)GetRandomValue(1, 0x7FFFFFFF);
+    GenerateTerrain(&mainWorld);
+    ResetLight();
+    ResetNav();
+    ResetRigidBodies();
+    ResetSurfaces();
+
+    // New map, new timeline (first commit writes a keyframe)
+    ResetHistory();
+}
+
+// Sets up w (any state, or all zero) with fresh terrain from seed
+void GenerateWorld(World* w, unsigned int seed) {
+    if (!w->grid) {
+        w->grid = w->storeA;
+        w->nextGrid = w->storeB;
+        w->simView = (Rectangle){ GRID_W / 2.0f, GRID_H / 2.0f, 0, 0 };
+    }
+    if (!w->stats) w->stats = &w->ownStats;
+    seed = seed * 0x9E3779B9u + 0x7F4A7C15u; // Spread nearby seeds out
+    w->rng = seed ? seed : 1;
+    GenerateTerrain(w);
+    ClearChanged(w);
 }
 
 bool IsSolid(BlockType t) {
@@ -100,228 +284,369 @@ bool IsSolid(BlockType t) {
     // These are ON TOP of the floor, which is dirt, that block player
 }
 
+bool IsFluid(BlockType t) {
+    return (t == BLOCK_WATER || t == BLOCK_LAVA);
+}
+
 bool IsValid(int x, int y) {
     return (x >= 0 && x < GRID_W && y >= 0 && y < GRID_H);
 }
 
+// --- WORLD ACCESS ---
+Cell GetCell(int x, int y) {
+    return UnpackCell(ReadState(mainWorld.grid, CellIndex(x, y)), x, y);
+}
+
+BlockType GetCellType(int x, int y) {
+    return STATE_TYPE(ReadState(mainWorld.grid, CellIndex(x, y)));
+}
+
+BlockType GetWorldCellType(const World* w, int x, int y) {
+    return STATE_TYPE(ReadState(w->grid, CellIndex(x, y)));
+}
+
+// Colors are ignored: they always follow from type and position
+void SetCell(int x, int y, Cell c) {
+    WriteState(&mainWorld, mainWorld.grid, CellIndex(x, y), MAKE_STATE(c.type, c.floor, c.life, c.active));
+    MarkChanged(&mainWorld, x, y);
+}
+
+const TickStats* GetWorldStats(const World* w) {
+    return w->stats;
+}
+
 // Brush Tool
 void EditWorld(int x, int y, BlockType type, int radius) {
+    BrushWorld(&mainWorld, x, y, type, radius);
+}
+
+void BrushWorld(World* w, int x, int y, BlockType type, int radius) {
     for(int j = -radius; j <= radius; j++) {
         for(int i = -radius; i <= radius; i++) {
             int nx = x + i;
             int ny = y + j;
             if (IsValid(nx, ny)) {
 
+                int idx = CellIndex(nx, ny);
+                CellState cell = ReadState(w->grid, idx);
+
                 // If the user selects DIRT, they are "Cleaning" the foreground to reveal the floor
                 BlockType placeType = (type == BLOCK_DIRT) ? BLOCK_AIR : type;
 
                 // Don't overwrite Solids if we are placing fluid (unless clearing with Air)
-                if (type == BLOCK_AIR || !IsSolid(grid[ny][nx].type)) {
-                    grid[ny][nx].type = placeType;
-                    // Add color based on what type of element on the screen
-                    grid[ny][nx].color = GetBlockColor(placeType);
-                    
+                if (type == BLOCK_AIR || !IsSolid(STATE_TYPE(cell))) {
                     // Initialize spread life
-                    if (placeType == BLOCK_WATER) grid[ny][nx].life = 5; 
-                    else if (type == BLOCK_LAVA) grid[ny][nx].life = 20;
-                    else if (type == BLOCK_FIRE) grid[ny][nx].life = 100;
-                    else grid[ny][nx].life = 0;
+                    int life;
+                    if (placeType == BLOCK_WATER) life = 5; 
+                    else if (type == BLOCK_LAVA) life = 20;
+                    else if (type == BLOCK_FIRE) life = 100;
+                    else life = 0;
                     
-                    grid[ny][nx].active = true; 
+                    // Color follows from the type (GetBlockColorAt), the floor stays
+                    WriteState(w, w->grid, idx, MAKE_STATE(placeType, STATE_FLOOR(cell), life, true));
+                    MarkChanged(w, nx, ny);
+                    w->stats->edited++;
                 }
             }
         }
     }
 }
 
+// --- SIMULATION LOD ---
+// The grid is split into CHUNK_SIZE x CHUNK_SIZE chunks. Chunks on screen
+// (and near it) run every tick, ones further off screen every 2nd, 4th or
+// 8th tick. A chunk that skips ticks catches up when it runs: it gets the
+// number of ticks it missed ("steps") and scales decay and chances by it, so
+// a far away fire still burns out on time, just in coarser jumps.
+//
+// Tier boundaries are safe because every chunk reads from grid (last tick)
+// and writes to nextGrid (checking it for conflicts), so a cell that crosses
+// into another chunk can never be simulated twice in the same tick.
+// Headless worlds keep the default view, a point in the middle of the map.
+
+// The part of the world the camera shows, zoom included
+void SetSimulationFocus(Camera2D camera) {
+    Vector2 a = GetScreenToWorld2D((Vector2){ 0, 0 }, camera);
+    Vector2 b = GetScreenToWorld2D((Vector2){ SCREEN_WIDTH, SCREEN_HEIGHT }, camera);
+    float x0 = fminf(a.x, b.x) / CELL_SIZE, y0 = fminf(a.y, b.y) / CELL_SIZE;
+    float x1 = fmaxf(a.x, b.x) / CELL_SIZE, y1 = fmaxf(a.y, b.y) / CELL_SIZE;
+    mainWorld.simView = (Rectangle){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+// By the distance between the chunk and the view (0 if any of it is on screen)
+static int LodTier(const World* w, int cx, int cy) {
+    const Rectangle* v = &w->simView;
+    float dx = fmaxf(fmaxf(v->x - (cx + 1) * CHUNK_SIZE, cx * CHUNK_SIZE - (v->x + v->width)), 0);
+    float dy = fmaxf(fmaxf(v->y - (cy + 1) * CHUNK_SIZE, cy * CHUNK_SIZE - (v->y + v->height)), 0);
+    float dist = sqrtf(dx * dx + dy * dy);
+    if (dist < LOD_TIER1_DIST) return 0;
+    if (dist < LOD_TIER2_DIST) return 1;
+    if (dist < LOD_TIER3_DIST) return 2;
+    return 3;
+}
+
+int GetChunkLodTier(int cx, int cy) {
+    return LodTier(&mainWorld, cx, cy);
+}
+
+// How many ticks this chunk should advance now (0 = not its turn)
+static int ChunkStepsDue(World* w, int cx, int cy) {
+    int period = 1 << LodTier(w, cx, cy);
+    int phase = (cx + cy * 3) & (period - 1); // Stagger so slow chunks don't all run on the same tick
+    if (((w->simTick + phase) & (period - 1)) != 0) return 0;
+
+    int steps = w->simTick - w->chunkLastTick[cy][cx];
+    w->chunkLastTick[cy][cx] = w->simTick;
+    if (steps > LOD_MAX_STEPS) steps = LOD_MAX_STEPS; // After a tier change, don't jump too far
+    return steps;
+}
+
+// Random roll that succeeds with probability `steps` / `sides` (1 in `sides` per tick)
+static bool RollPerTick(World* w, int sides, int steps) {
+    return RandomRange(w, 0, sides - 1) < steps;
+}
+
 // --- CELLULAR AUTOMATA ENGINE ---
-void UpdateWorld() {
-    // 1. Copy State
-    for(int y=0; y<GRID_H; y++) {
-        for(int x=0; x<GRID_W; x++) {
-            nextGrid[y][x] = grid[y][x];
+
+// Writes a freshly created cell of type t into the next state
+static void SpawnCell(World* w, int x, int y, BlockType t) {
+    int idx = CellIndex(x, y);
+    CellState s = ReadState(w->nextGrid, idx);
+    WriteState(w, w->nextGrid, idx, STATE_WITH_LIFE(STATE_WITH_TYPE(s, t), Materials[t].spawnLife));
+    MarkChanged(w, x, y);
+}
+
+// Drops a by-product into a random free 4-neighbour of (x, y), if there is one
+static void SpawnByproduct(World* w, int x, int y, BlockType t) {
+    static const int offsets[4][2] = { {0,-1}, {1,0}, {0,1}, {-1,0} };
+    int start = RandomRange(w, 0, 3);
+    for (int k = 0; k < 4; k++) {
+        int nx = x + offsets[(start + k) & 3][0];
+        int ny = y + offsets[(start + k) & 3][1];
+        if (!IsValid(nx, ny)) continue;
+        int idx = CellIndex(nx, ny);
+        if (STATE_TYPE(ReadState(w->grid, idx)) == BLOCK_AIR && STATE_TYPE(ReadState(w->nextGrid, idx)) == BLOCK_AIR) {
+            SpawnCell(w, nx, ny, t);
+            return;
         }
     }
+}
 
-    // 2. Physics Pass
-    for(int y = 0; y < GRID_H; y++) {
-        for(int x = 0; x < GRID_W; x++) {
-            Cell c = grid[y][x];
-
-            // Skip Empty Air (Optimization)
-            if (c.type == BLOCK_AIR || c.type == BLOCK_DIRT || IsSolid(c.type)) continue;
-
-            // Coordinates (x, y)
-            int dx = 0, dy = 0; 
-
-            // --- FLUIDS (Water, Lava) ---
-            if (c.type == BLOCK_WATER || c.type == BLOCK_LAVA) {
-                if (c.life <= 0) continue; // Settled
-                // Viscosity check
-                // int skipChance = (c.type == BLOCK_LAVA) ? 10 : 2;
-                // if (GetRandomValue(0, skipChance) != 0) continue;
-                if (c.type == BLOCK_LAVA && GetRandomValue(0, 10) != 0) continue; // Viscosity
-                if (c.type == BLOCK_WATER && GetRandomValue(0, 2) != 0) continue;
-
-                
-
-                // Random Direction
-                int dir = GetRandomValue(0, 3);
-                switch(dir){
-                    case 0:
-                        dy = -1;
-                        break;
-                    case 1:
-                        dx = 1;
-                        break;
-                    case 2:
-                        dy = 1;
-                        break;
-                    case 3:
-                        dx = -1;
-                        break;
-                    default:
-                        dx = 1;
-                }
+// Applies matrix entry r between us (x, y) and neighbour (nx, ny).
+// Returns true if we turned into something else.
+static bool ApplyReaction(World* w, int x, int y, int nx, int ny, BlockType self, BlockType other, const Reaction* r) {
+    // Check NextGrid to avoid race conditions (someone may have moved in already)
+    if (STATE_TYPE(ReadState(w->nextGrid, CellIndex(nx, ny))) != other) return false;
+
+    w->stats->reactions++;
+    if (r->other == BLOCK_FIRE && other != BLOCK_FIRE) w->stats->ignitions++;
+    if (r->other != other) SpawnCell(w, nx, ny, r->other);
+    if (r->byproduct != BLOCK_AIR) SpawnByproduct(w, nx, ny, r->byproduct);
+    if (r->self != self) {
+        SpawnCell(w, x, y, r->self);
+        return true;
+    }
+    return false;
+}
 
-                if (IsValid(x+dx, y+dy)) {
-                    BlockType target = grid[y+dy][x+dx].type;
-                    int myDen = GetDensity(c.type);
-                    int targetDen = GetDensity(target);
-
-                    // Move if target is AIR or Lighter Fluid
-                    // We check 'target != BLOCK_DIRT' just in case, to protect the floor.
-                    if (target != BLOCK_DIRT && !IsSolid(target) && myDen > targetDen) {
-                        // Check NextGrid to avoid race conditions
-                        if (nextGrid[y+dy][x+dx].type == target) {
-                            
-                            // 1. Move Fluid to New Spot
-                            nextGrid[y+dy][x+dx].type = c.type;
-                            nextGrid[y+dy][x+dx].life = c.life - 1;
-                            nextGrid[y+dy][x+dx].color = c.color;
-
-                            // 2. Leave AIR behind at Old Spot (Revealing the Dirt Floor)
-                            nextGrid[y][x].type = BLOCK_AIR; 
-                            // Note: We do NOT touch .floor, so the dirt stays!
-                        }
-                    }
-                }
+static void UpdateCell(World* w, int idx, int x, int y, int steps) {
+    const Chunk* grid = w->grid;
+    Chunk* nextGrid = w->nextGrid;
+    CellState c = ReadState(grid, idx);
+    BlockType type = STATE_TYPE(c);
+    const MaterialRule* m = &Materials[type];
+
+    // Skip Empty Air, Floor and Solids (Optimization)
+    if (m->flags == 0) return;
+    w->stats->active++;
+    // Something heavier already took our spot this tick
+    CellState next = ReadState(nextGrid, idx);
+    if (STATE_TYPE(next) != type) return;
+
+    // --- REACTIONS (matrix lookup per neighbour, see reactions.c) ---
+    if (m->flags & MAT_REACTIVE) {
+        const Reaction* row = GetReaction(type, 0);
+        for(int j=-1; j<=1; j++) {
+            for(int i=-1; i<=1; i++) {
+                if ((i == 0 && j == 0) || !IsValid(x+i, y+j)) continue;
+                BlockType other = STATE_TYPE(ReadState(grid, NeighbourIndex(idx, x, y, i, j)));
+                const Reaction* r = &row[other];
+                if (r->sides && RollPerTick(w, r->sides, steps) && ApplyReaction(w, x, y, x+i, y+j, type, other, r)) return;
             }
+        }
+    }
 
-            // --- FIRE ---
-            else if (c.type == BLOCK_FIRE) {
-                // Spread
-                for(int i=-1; i<=1; i++) {
-                    for(int j=-1; j<=1; j++) {
-                        if(IsValid(x+i, y+j) && grid[y+j][x+i].type == BLOCK_WOOD) {
-                            if(GetRandomValue(0, 20) == 0) {
-                                nextGrid[y+j][x+i].type = BLOCK_FIRE;
-                                nextGrid[y+j][x+i].life = 150;
-                                nextGrid[y+j][x+i].color = GetBlockColor(BLOCK_FIRE);
-                            }
-                        }
-                    }
-                }
-                // Decay
-                nextGrid[y][x].life--;
-                nextGrid[y][x].color = GetBlockColor(BLOCK_FIRE); 
-                if(nextGrid[y][x].life <= 0) {
-                    nextGrid[y][x].type = BLOCK_SMOKE;
-                    nextGrid[y][x].life = 60;
-                    nextGrid[y][x].color = GetBlockColor(BLOCK_SMOKE);
-                }
-            }
+    // --- DECAY (Fire burns down, Smoke thins out) ---
+    // (MAT_FLICKER colors are re-rolled by DrawWorld, nothing to store here)
+    int life = STATE_LIFE(c);
+    if (m->flags & MAT_DECAYS) {
+        life = STATE_LIFE(next) - steps;
+        MarkChanged(w, x, y);
+        if (life <= 0) {
+            SpawnCell(w, x, y, m->decayInto);
+            return;
+        }
+        next = STATE_WITH_LIFE(next, life);
+        WriteState(w, nextGrid, idx, next);
+    }
 
-            // --- SMOKE ---
-            else if (c.type == BLOCK_SMOKE) {
-                if (GetRandomValue(0, 3) == 0) {
-                    int dir = GetRandomValue(0, 3);
-                    switch(dir){
-                        case 0:
-                            dy = -1;
-                            break;
-                        case 1:
-                            dx = 1;
-                            break;
-                        case 2:
-                            dy = 1;
-                            break;
-                        case 3:
-                            dx = -1;
-                            break;
-                        default:
-                            dx = 1;
-                    }
-                    
-                    if (IsValid(x+dx, y+dy) && grid[y+dy][x+dx].type == BLOCK_DIRT) {
-                         if (nextGrid[y+dy][x+dx].type == BLOCK_DIRT) {
-                            nextGrid[y+dy][x+dx] = c;
-                            nextGrid[y][x].type = BLOCK_DIRT;
-                         }
-                    }
-                }
-                nextGrid[y][x].life--;
-                if(nextGrid[y][x].life <= 0) nextGrid[y][x].type = BLOCK_DIRT;
-            }
+    // --- MOVEMENT (Fluids, Gases) ---
+    if (!(m->flags & MAT_MOVES)) return;
+    if ((m->flags & MAT_SETTLES) && life <= 0) return; // Settled
+    if (!RollPerTick(w, m->moveSides, steps)) return;  // Viscosity
+
+    // Random Direction
+    int dx = 0, dy = 0;
+    switch(RandomRange(w, 0, 3)){
+        case 0: dy = -1; break;
+        case 1: dx = 1; break;
+        case 2: dy = 1; break;
+        default: dx = -1; break;
+    }
+    if (!IsValid(x+dx, y+dy)) return;
+
+    // Density decides who gives way (compiled into the matrix as REACT_DISPLACE)
+    int targetIdx = NeighbourIndex(idx, x, y, dx, dy);
+    BlockType target = STATE_TYPE(ReadState(grid, targetIdx));
+    if (!(GetReaction(type, target)->flags & REACT_DISPLACE)) return;
+    // Check NextGrid to avoid race conditions
+    CellState dest = ReadState(nextGrid, targetIdx);
+    if (STATE_TYPE(dest) != target) return;
+
+    // 1. Move to New Spot (fluids spend 1 life per move)
+    int movedLife = (m->flags & MAT_SETTLES) ? life - 1 : life;
+    WriteState(w, nextGrid, targetIdx, STATE_WITH_LIFE(STATE_WITH_TYPE(dest, type), movedLife));
+
+    // 2. Leave AIR behind at Old Spot (Revealing the Dirt Floor)
+    WriteState(w, nextGrid, idx, STATE_WITH_TYPE(next, BLOCK_AIR));
+    // Note: We do NOT touch the floor, so the dirt stays!
+
+    MarkChanged(w, x + dx, y + dy);
+    MarkChanged(w, x, y);
+    w->stats->moved[type]++;
+    if ((m->flags & MAT_SETTLES) && life == 1) w->stats->settled++;
+}
+
+// A uniform chunk of something that can't do anything has nothing to simulate
+static bool ChunkIsInert(const Chunk* c) {
+    if (c->kind != CHUNK_UNIFORM) return false;
+    unsigned char flags = Materials[STATE_TYPE(c->palette[0])].flags;
+    if (flags == 0) return true;
+    // A settled fluid (no reactions, no decay) just sits there too
+    return (flags & ~(MAT_MOVES | MAT_SETTLES)) == 0 && (flags & MAT_SETTLES) && STATE_LIFE(c->palette[0]) <= 0;
+}
+
+static void CompactGrid(World* w) {
+    for (int cy = 0; cy < CHUNKS_Y; cy++) {
+        for (int cx = 0; cx < CHUNKS_X; cx++) {
+            int vw = GRID_W - cx * CHUNK_SIZE, vh = GRID_H - cy * CHUNK_SIZE;
+            CompactChunk(&w->pool, &w->grid[cy * CHUNKS_X + cx], vw < CHUNK_SIZE ? vw : CHUNK_SIZE, vh < CHUNK_SIZE ? vh : CHUNK_SIZE);
         }
     }
+}
 
-    // 3. Swap (Apply)
-    for(int y=0; y<GRID_H; y++) {
-        for(int x=0; x<GRID_W; x++) {
-            grid[y][x] = nextGrid[y][x];
+void CompactWorld() {
+    CompactGrid(&mainWorld);
+}
+
+// Chunks by form, and bytes held by both buffers
+void GetWorldStorage(int* uniform, int* palette, int* full, int* bytes) {
+    const Chunk* grid = mainWorld.grid;
+    const Chunk* nextGrid = mainWorld.nextGrid;
+    int counts[3] = { 0, 0, 0 };
+    *bytes = 0;
+    for (int i = 0; i < CHUNK_COUNT; i++) {
+        counts[grid[i].kind]++;
+        *bytes += ChunkBytes(&grid[i]) + ChunkBytes(&nextGrid[i]);
+    }
+    *uniform = counts[CHUNK_UNIFORM];
+    *palette = counts[CHUNK_PALETTE];
+    *full = counts[CHUNK_FULL];
+}
+
+// One tick of the cells of any world: every system that follows the main
+// world hooks in around this in UpdateWorld.
+static void SimulateTick(World* w) {
+    // 1. Copy State (per chunk: a uniform chunk is a few bytes)
+    for (int i = 0; i < CHUNK_COUNT; i++) ChunkCopy(&w->pool, &w->nextGrid[i], &w->grid[i]);
+
+    // 2. Physics Pass (only the chunks whose LOD tier is due this tick)
+    w->simTick++;
+    for (int cy = 0; cy < CHUNKS_Y; cy++) {
+        for (int cx = 0; cx < CHUNKS_X; cx++) {
+            int steps = ChunkStepsDue(w, cx, cy);
+            if (steps == 0 || ChunkIsInert(&w->grid[cy * CHUNKS_X + cx])) continue;
+
+            int maxY = (cy + 1) * CHUNK_SIZE < GRID_H ? (cy + 1) * CHUNK_SIZE : GRID_H;
+            int maxX = (cx + 1) * CHUNK_SIZE < GRID_W ? (cx + 1) * CHUNK_SIZE : GRID_W;
+            w->stats->visited += (maxY - cy * CHUNK_SIZE) * (maxX - cx * CHUNK_SIZE);
+            for (int y = cy * CHUNK_SIZE; y < maxY; y++) {
+                for (int x = cx * CHUNK_SIZE; x < maxX; x++) {
+                    UpdateCell(w, CellIndex(x, y), x, y, steps);
+                }
+            }
         }
     }
+
+    // 3. Swap (Apply), then re-pack the chunks that changed
+    Chunk* applied = w->nextGrid;
+    w->nextGrid = w->grid;
+    w->grid = applied;
+    CompactGrid(w);
+}
+
+void UpdateWorld() {
+    double start = GetTime();
+    SimulateTick(&mainWorld);
+
+    // 4. Loose pieces slide (they write into the grid when they weld)
+    UpdateRigidBodies();
+
+    // 5. Record (rewind history, replication, stats)
+    CommitTick();
+    CommitStats((float)((GetTime() - start) * 1000.0));
+}
+
+// A headless world has nobody listening for changes: just forget them
+void StepWorld(World* w) {
+    memset(&w->ownStats, 0, sizeof(w->ownStats));
+    SimulateTick(w);
+    ClearChanged(w);
 }
 
 // --- RENDER GRID ---
-void DrawWorld() {
-    // Thickness of the border lines (1 or 2 looks best)
-    int lineThickness = 2; 
+static Color Shade(Color c, float brightness) {
+    return (Color){ (unsigned char)(c.r * brightness), (unsigned char)(c.g * brightness), (unsigned char)(c.b * brightness), c.a };
+}
 
+void DrawWorld() {
     for(int y=0; y<GRID_H; y++) {
         for(int x=0; x<GRID_W; x++) {
-            Cell c = grid[y][x];
-            // if (c.type == BLOCK_AIR) continue;
+            CellState c = ReadState(mainWorld.grid, CellIndex(x, y));
+            BlockType type = STATE_TYPE(c);
 
             int px = x * CELL_SIZE;
             int py = y * CELL_SIZE;
 
-            // ALWAYS Draw Floor First (Dirt)
-            // Even if there is water, we draw dirt first so it shows through transparent water
-            DrawRectangle(px, py, CELL_SIZE, CELL_SIZE, c.floorColor);
+            // Light from fire and lava (see light.c); glowing cells are always full bright
+            float brightness = LIGHT_AMBIENT + (1.0f - LIGHT_AMBIENT) * GetLight(x, y) / LIGHT_MAX;
 
-            // Draw Foreground (If not Air)
-            if (c.type != BLOCK_AIR) {
-                DrawRectangle(px, py, CELL_SIZE, CELL_SIZE, c.color);
-            }
+            // Floor first (Dirt), so it shows through transparent water.
+            // Walls cover it completely, so skip it there.
+            if (!IsSolid(type)) DrawRectangle(px, py, CELL_SIZE, CELL_SIZE, Shade(GetBlockColorAt(STATE_FLOOR(c), x, y), brightness));
 
-            // 2. Draw Outlines ONLY for Solid blocks (Walls)
-            if (IsSolid(c.type)) {
-                Color outlineColor = Fade(BLACK, 0.5f);
-                
-                // --- BORDER LOGIC ---
-                // We draw a border if the neighbor is a DIFFERENT TYPE.
-                // This separates Stone from Dirt, but also Stone from Wood.
-                
-                // Check UP
-                if (IsValid(x, y-1) && grid[y-1][x].type != c.type) 
-                    DrawRectangle(px, py, CELL_SIZE, lineThickness, outlineColor);
-                
-                // Check DOWN
-                if (IsValid(x, y+1) && grid[y+1][x].type != c.type) 
-                    DrawRectangle(px, py + CELL_SIZE - lineThickness, CELL_SIZE, lineThickness, outlineColor);
-
-                // Check LEFT
-                if (IsValid(x-1, y) && grid[y][x-1].type != c.type) 
-                    DrawRectangle(px, py, lineThickness, CELL_SIZE, outlineColor);
-
-                // Check RIGHT
-                if (IsValid(x+1, y) && grid[y][x+1].type != c.type) 
-                    DrawRectangle(px + CELL_SIZE - lineThickness, py, lineThickness, CELL_SIZE, outlineColor);
+            // Draw Foreground (If not Air). Fire re-rolls its color every frame.
+            // Water and lava are smooth shapes drawn by DrawSurfaces.
+            if (type != BLOCK_AIR && !IsFluid(type)) {
+                Color color = (Materials[type].flags & MAT_FLICKER) ? GetBlockColor(type) : GetBlockColorAt(type, x, y);
+                if (Materials[type].emitLight == 0) color = Shade(color, brightness);
+                DrawRectangle(px, py, CELL_SIZE, CELL_SIZE, color);
             }
         }
     }
+
+    // Liquid shapes and the outlines of walls and liquids (see surfaces.c)
+    DrawSurfaces();
 }
 
 // --- PLAYER PHYSICS (MOVE AND SLIDE) ---
@@ -342,7 +667,7 @@ bool CheckCollision(Vector2 pos, float radius) {
 
     for (int y = minY; y <= maxY; y++) {
         for (int x = minX; x <= maxX; x++) {
-            if (IsValid(x, y) && IsSolid(grid[y][x].type)) {
+            if (IsValid(x, y) && IsSolid(STATE_TYPE(ReadState(mainWorld.grid, CellIndex(x, y))))) {
                 return true;
             }
         }
@@ -364,13 +689,13 @@ void UpdatePlayer(Player* p, float dt) {
     
     // 1. Try Moving X
     Vector2 nextPosX = { p->position.x + p->velocity.x * dt, p->position.y };
-    if (!CheckCollision(nextPosX, p->size)) {
+    if (!CheckCollision(nextPosX, p->size) && !PushRigidBodies(nextPosX, p->size, (Vector2){ p->velocity.x, 0 })) {
         p->position.x = nextPosX.x;
     }
     
     // 2. Try Moving Y (Independent of X)
     Vector2 nextPosY = { p->position.x, p->position.y + p->velocity.y * dt };
-    if (!CheckCollision(nextPosY, p->size)) {
+    if (!CheckCollision(nextPosY, p->size) && !PushRigidBodies(nextPosY, p->size, (Vector2){ 0, p->velocity.y })) {
         p->position.y = nextPosY.y;
     }
     
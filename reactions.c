@@ -0,0 +1,69 @@
+#include "game.h"
+
+// --- MATERIAL CHEMISTRY ---
+// All cell interactions are data. The rule lists below are compiled once by
+// InitReactions() into flat tables that UpdateWorld indexes directly, so
+// adding chemistry means adding a line here, not another branch in the loop.
+
+Reaction ReactionMatrix[BLOCK_COUNT * BLOCK_COUNT];
+MaterialRule Materials[BLOCK_COUNT];
+
+// How each material behaves on its own
+static const MaterialRule materialRules[BLOCK_COUNT] = {
+    //               moves 1 in N  turns into when life ends  starting life  behaviour                         light
+    [BLOCK_STONE] = { .opacity = LIGHT_OPAQUE },
+    [BLOCK_SAND]  = { .opacity = LIGHT_OPAQUE },
+    [BLOCK_WOOD]  = { .opacity = LIGHT_OPAQUE },
+    [BLOCK_WATER] = { .moveSides = 3,  .decayInto = BLOCK_AIR,   .spawnLife = 5,   .flags = MAT_MOVES | MAT_SETTLES },
+    [BLOCK_LAVA]  = { .moveSides = 11, .decayInto = BLOCK_AIR,   .spawnLife = 20,  .flags = MAT_MOVES | MAT_SETTLES, .emitLight = 12 },
+    [BLOCK_FIRE]  = { .moveSides = 0,  .decayInto = BLOCK_SMOKE, .spawnLife = 150, .flags = MAT_DECAYS | MAT_FLICKER, .emitLight = LIGHT_MAX },
+    [BLOCK_SMOKE] = { .moveSides = 4,  .decayInto = BLOCK_AIR,   .spawnLife = 60,  .flags = MAT_MOVES | MAT_DECAYS,  .opacity = 2 },
+};
+
+// What happens when material A (the one being updated) touches material B.
+// Only A scans its neighbours, so list a pair from the side that is "active".
+typedef struct {
+    BlockType a, b;
+    BlockType aBecomes, bBecomes;
+    BlockType byproduct; // Released into an empty cell next to B (BLOCK_AIR = none)
+    int sides;           // Happens 1 in N ticks
+} ReactionRule;
+
+static const ReactionRule reactionRules[] = {
+    { BLOCK_FIRE, BLOCK_WOOD,  BLOCK_FIRE,  BLOCK_FIRE,  BLOCK_AIR,   21 }, // Wood catches fire
+    { BLOCK_FIRE, BLOCK_WATER, BLOCK_SMOKE, BLOCK_WATER, BLOCK_AIR,   4  }, // Water puts fire out
+    { BLOCK_LAVA, BLOCK_WATER, BLOCK_STONE, BLOCK_SMOKE, BLOCK_AIR,   2  }, // Lava cools, water boils off
+    { BLOCK_LAVA, BLOCK_WOOD,  BLOCK_LAVA,  BLOCK_FIRE,  BLOCK_SMOKE, 30 }, // Lava sets wood alight
+};
+
+// Can A push its way into B's cell? Heavier fluids sink through lighter ones,
+// gases only drift into empty air, and nothing moves into solids or the floor.
+static bool CanDisplace(BlockType a, BlockType b) {
+    if (!(materialRules[a].flags & MAT_MOVES)) return false;
+    if (b == BLOCK_DIRT || IsSolid(b)) return false;
+    if (GetDensity(a) <= GetDensity(b)) return false;
+    if (GetDensity(a) < DENSITY_LIQUID && b != BLOCK_AIR) return false;
+    return true;
+}
+
+void InitReactions() {
+    for (int a = 0; a < BLOCK_COUNT; a++) {
+        Materials[a] = materialRules[a];
+        for (int b = 0; b < BLOCK_COUNT; b++) {
+            Reaction* r = GetReaction(a, b);
+            *r = (Reaction){ .self = a, .other = b, .byproduct = BLOCK_AIR, .sides = 0, .flags = 0 };
+            if (CanDisplace(a, b)) r->flags |= REACT_DISPLACE;
+        }
+    }
+
+    int ruleCount = sizeof(reactionRules) / sizeof(reactionRules[0]);
+    for (int i = 0; i < ruleCount; i++) {
+        const ReactionRule* rule = &reactionRules[i];
+        Reaction* r = GetReaction(rule->a, rule->b);
+        r->self = rule->aBecomes;
+        r->other = rule->bBecomes;
+        r->byproduct = rule->byproduct;
+        r->sides = rule->sides;
+        Materials[rule->a].flags |= MAT_REACTIVE; // Only these scan their neighbours
+    }
+}
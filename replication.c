@@ -0,0 +1,269 @@
+#define _POSIX_C_SOURCE 200112L // sockets under -std=c99
+#include "game.h"
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// --- WORLD REPLICATION (LOCAL SPECTATORS) ---
+// The server streams the world over UDP on loopback; a spectator process
+// applies what it receives and only draws (no simulation of its own).
+//
+// Each tick the server sends:
+//  1. A few full chunks, cycling through the map ("rolling keyframe"), so a
+//     spectator that joins late or drops a packet heals within a second.
+//  2. Every chunk with changes: only the changed cells, or the whole chunk
+//     when most of it changed.
+// A token bucket caps bandwidth. Chunks that don't fit stay dirty and go out
+// on a later tick, so payload follows activity, not map size.
+//
+// Packet: 'N' 'R' [tick: 4 bytes] then records:
+//   REC_CHUNK_FULL  [chunk varint] [cells, each diffed against the previous one]
+//   REC_CHUNK_DELTA [chunk varint] [count varint] ([cell in chunk: 1 byte] [cell diffed against last sent])...
+
+#define REC_CHUNK_FULL 1
+#define REC_CHUNK_DELTA 2
+#if CHUNK_CELLS > 256
+#error "Delta records address cells in a chunk with one byte"
+#endif
+#define FULL_CHUNK_THRESHOLD (CHUNK_CELLS / 2) // Send the whole chunk past this many changes
+#define RECORD_MAX_BYTES (8 + CHUNK_CELLS * (1 + CELL_MAX_BYTES)) // Header, then cell byte + cell per delta
+
+static int sock = -1;
+static bool serving = false;
+static struct sockaddr_in peer;
+
+static unsigned char packet[REPL_PACKET_SIZE];
+static int packetLen = 0;
+static unsigned int replTick = 0;
+static float tokens = 0;     // Bandwidth budget left (bytes)
+static int bytesThisTick = 0;
+static int bytesLastTick = 0;
+
+// Server: what spectators should have, and what still needs sending
+static Cell sent[GRID_H][GRID_W];
+static bool cellDirty[GRID_H][GRID_W];
+static int chunkDirty[CHUNKS_Y][CHUNKS_X]; // Number of dirty cells per chunk
+static int keyframeCursor = 0;
+static int dirtyCursor = 0;
+
+// --- SOCKETS ---
+
+static bool OpenSocket(int port, bool bindIt) {
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) return false;
+
+    memset(&peer, 0, sizeof(peer));
+    peer.sin_family = AF_INET;
+    peer.sin_port = htons((unsigned short)port);
+    peer.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bindIt && bind(sock, (struct sockaddr*)&peer, sizeof(peer)) < 0) {
+        close(sock); sock = -1;
+        return false;
+    }
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+    return true;
+}
+
+static void FlushPacket() {
+    if (packetLen > 6) {
+        sendto(sock, packet, packetLen, 0, (struct sockaddr*)&peer, sizeof(peer));
+        tokens -= packetLen;
+        bytesThisTick += packetLen;
+    }
+    packet[0] = 'N'; packet[1] = 'R';
+    packet[2] = replTick & 0xFF; packet[3] = (replTick >> 8) & 0xFF;
+    packet[4] = (replTick >> 16) & 0xFF; packet[5] = (replTick >> 24) & 0xFF;
+    packetLen = 6;
+}
+
+// Makes sure the next record fits in the current packet
+static void ReserveRecord() {
+    if (packetLen + RECORD_MAX_BYTES > REPL_PACKET_SIZE) FlushPacket();
+}
+
+// --- SERVER ---
+
+static void ChunkBounds(int chunk, int* x0, int* y0, int* x1, int* y1) {
+    *x0 = (chunk % CHUNKS_X) * CHUNK_SIZE;
+    *y0 = (chunk / CHUNKS_X) * CHUNK_SIZE;
+    *x1 = (*x0 + CHUNK_SIZE < GRID_W) ? *x0 + CHUNK_SIZE : GRID_W;
+    *y1 = (*y0 + CHUNK_SIZE < GRID_H) ? *y0 + CHUNK_SIZE : GRID_H;
+}
+
+static void WriteChunkFull(int chunk) {
+    int x0, y0, x1, y1;
+    ChunkBounds(chunk, &x0, &y0, &x1, &y1);
+    ReserveRecord();
+    packet[packetLen++] = REC_CHUNK_FULL;
+    packetLen += WriteVarint(packet + packetLen, chunk);
+
+    Cell prev = {0};
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            sent[y][x] = GetCell(x, y);
+            cellDirty[y][x] = false;
+            packetLen += EncodeCell(packet + packetLen, &prev, &sent[y][x]);
+            prev = sent[y][x];
+        }
+    }
+    chunkDirty[chunk / CHUNKS_X][chunk % CHUNKS_X] = 0;
+}
+
+static void WriteChunkDelta(int chunk) {
+    int x0, y0, x1, y1;
+    ChunkBounds(chunk, &x0, &y0, &x1, &y1);
+    ReserveRecord();
+    packet[packetLen++] = REC_CHUNK_DELTA;
+    packetLen += WriteVarint(packet + packetLen, chunk);
+    packetLen += WriteVarint(packet + packetLen, chunkDirty[chunk / CHUNKS_X][chunk % CHUNKS_X]);
+
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            if (!cellDirty[y][x]) continue;
+            Cell c = GetCell(x, y);
+            packet[packetLen++] = (unsigned char)((y - y0) * CHUNK_SIZE + (x - x0));
+            packetLen += EncodeCell(packet + packetLen, &sent[y][x], &c);
+            sent[y][x] = c;
+            cellDirty[y][x] = false;
+        }
+    }
+    chunkDirty[chunk / CHUNKS_X][chunk % CHUNKS_X] = 0;
+}
+
+static void TrackReplicationMemory() {
+    TrackStatic(MEM_WORLD, "replication", sizeof(packet) + sizeof(sent) + sizeof(cellDirty) + sizeof(chunkDirty));
+}
+
+bool StartReplicationServer(int port) {
+    if (!OpenSocket(port, false)) return false;
+    TrackReplicationMemory();
+    serving = true;
+    FlushPacket();
+    return true;
+}
+
+// Called once per committed world tick with the cells that may have changed
+void ReplicationServerTick(const int* changed, int count) {
+    if (!serving) return;
+    replTick++;
+    bytesThisTick = 0;
+
+    // 1. Remember what differs from what spectators have
+    for (int i = 0; i < count; i++) {
+        int x = changed[i] % GRID_W, y = changed[i] / GRID_W;
+        if (cellDirty[y][x]) continue;
+        Cell c = GetCell(x, y);
+        if (CellEquals(&c, &sent[y][x])) continue;
+        cellDirty[y][x] = true;
+        chunkDirty[y / CHUNK_SIZE][x / CHUNK_SIZE]++;
+    }
+
+    // 2. Refill the bandwidth budget (at most one second's worth banked)
+    tokens += REPL_BYTES_PER_SECOND / 60.0f;
+    if (tokens > REPL_BYTES_PER_SECOND) tokens = REPL_BYTES_PER_SECOND;
+    FlushPacket();
+
+    // 3. Rolling keyframe
+    for (int k = 0; k < REPL_KEYFRAME_CHUNKS && tokens - packetLen > 0; k++) {
+        WriteChunkFull(keyframeCursor);
+        keyframeCursor = (keyframeCursor + 1) % (CHUNKS_X * CHUNKS_Y);
+    }
+
+    // 4. Changed chunks, round-robin so a busy corner can't starve the rest
+    int total = CHUNKS_X * CHUNKS_Y;
+    for (int k = 0; k < total && tokens - packetLen > 0; k++) {
+        int chunk = (dirtyCursor + k) % total;
+        int dirty = chunkDirty[chunk / CHUNKS_X][chunk % CHUNKS_X];
+        if (dirty == 0) continue;
+        if (dirty > FULL_CHUNK_THRESHOLD) WriteChunkFull(chunk);
+        else WriteChunkDelta(chunk);
+        dirtyCursor = (chunk + 1) % total;
+    }
+    FlushPacket();
+    bytesLastTick = bytesThisTick;
+}
+
+// --- SPECTATOR ---
+
+bool StartSpectator(int port) {
+    if (!OpenSocket(port, true)) return false;
+    TrackReplicationMemory();
+    return true;
+}
+
+// Anyone on the machine can send to the port, so every read is checked
+// against len first and every cell against its chunk. A record that doesn't
+// fit ends the packet; a cell outside its chunk or with an unknown material is
+// skipped.
+static bool ValidCell(const Cell* c) {
+    return c->type < BLOCK_COUNT && c->floor < BLOCK_COUNT;
+}
+
+static void ApplyPacket(const unsigned char* in, int len) {
+    if (len < 6 || in[0] != 'N' || in[1] != 'R') return;
+    int n = 6;
+    while (n < len) {
+        int kind = in[n++];
+        unsigned int chunk;
+        if (MeasureVarint(in + n, len - n) == 0) return;
+        n += ReadVarint(in + n, &chunk);
+        if (chunk >= CHUNKS_X * CHUNKS_Y) return; // Not our map size
+        int x0, y0, x1, y1;
+        ChunkBounds(chunk, &x0, &y0, &x1, &y1);
+
+        if (kind == REC_CHUNK_FULL) {
+            Cell prev = {0};
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) {
+                    Cell c;
+                    if (MeasureCell(in + n, len - n) == 0) return;
+                    n += DecodeCell(in + n, &prev, &c);
+                    if (ValidCell(&c)) SetCell(x, y, c);
+                    prev = c;
+                }
+            }
+        } else if (kind == REC_CHUNK_DELTA) {
+            unsigned int count;
+            if (MeasureVarint(in + n, len - n) == 0) return;
+            n += ReadVarint(in + n, &count);
+            for (unsigned int k = 0; k < count; k++) {
+                if (n >= len) return;
+                int local = in[n++];
+                int x = x0 + local % CHUNK_SIZE, y = y0 + local / CHUNK_SIZE;
+                bool inside = x < x1 && y < y1; // Edge chunks are narrower than CHUNK_SIZE
+                Cell base = inside ? GetCell(x, y) : (Cell){0};
+                Cell c;
+                if (MeasureCell(in + n, len - n) == 0) return;
+                n += DecodeCell(in + n, &base, &c);
+                if (inside && ValidCell(&c)) SetCell(x, y, c);
+            }
+        } else {
+            return; // Unknown record, drop the rest of the packet
+        }
+    }
+}
+
+// Applies everything that arrived since the last call
+void PollSpectator() {
+    static unsigned char buffer[REPL_PACKET_SIZE];
+    bytesThisTick = 0;
+    int len;
+    while ((len = (int)recv(sock, buffer, sizeof(buffer), 0)) > 0) {
+        ApplyPacket(buffer, len);
+        bytesThisTick += len;
+    }
+    CompactWorld(); // No UpdateWorld here to re-pack the chunks we wrote
+    bytesLastTick = bytesThisTick;
+}
+
+int GetReplicationBytes() {
+    return bytesLastTick;
+}
+
+bool IsReplicating() {
+    return sock >= 0;
+}
@@ -0,0 +1,526 @@
+#include "game.h"
+#include <string.h>
+
+// --- STRUCTURAL INTEGRITY ---
+// Solid cells (IsSolid) are kept in a union-find, one set per connected
+// cluster. Placing a solid just unions it with its solid neighbours. Removal
+// can't be undone in a union-find, so the sets only ever over-approximate:
+// two cells with different roots are certainly apart, two with the same root
+// may have been split since.
+//
+// When solids disappear (mined, burned), we look for a split right there:
+// every solid neighbour of a removed cell starts a small BFS, all of them
+// taking turns one cell at a time. Searches that touch merge. A search group
+// that runs out of cells before RIGID_MAX_CELLS is a piece that broke off;
+// the rest of the map is never walked, only RIGID_MAX_CELLS per seed at most.
+//
+// A piece that broke off (and isn't the biggest piece left) leaves the grid
+// and becomes a rigid body. The world is seen from above, so nothing falls:
+// the blow that broke it off sends it sliding, the player can shove it, and
+// it stops on friction. Once it rests against solid ground it is written back
+// into the grid ("welded") and joins that cluster again.
+
+#define RIGID_CELLS (GRID_W * GRID_H)
+#define RIGID_MAX_SEEDS 256 // Solid cells around the holes of one tick, per cluster
+#define RIGID_DT (1.0f / 60.0f)   // UpdateWorld runs once per frame at 60 FPS
+#define RIGID_KICK 12.0f          // Cells/s a piece flies off with when it breaks loose
+#define RIGID_FRICTION 0.93f      // Speed kept per tick
+#define RIGID_REST_SPEED 0.5f     // Cells/s below which a body counts as resting
+#define RIGID_PUSH_CELLS 32.0f    // Bodies up to this size move at the player's full speed
+#if GRID_W > 256 || GRID_H > 256
+#error "Body cell offsets are stored as bytes"
+#endif
+
+typedef struct {
+    bool active;
+    Vector2 position;  // Grid position of cell offset (0, 0), in cells
+    Vector2 velocity;  // Cells per second
+    int count;
+    int w, h;          // Bounding box of the offsets
+    unsigned char dx[RIGID_MAX_CELLS], dy[RIGID_MAX_CELLS]; // Offsets from the top-left of the bounding box
+    unsigned char type[RIGID_MAX_CELLS];
+} RigidBody;
+
+static RigidBody bodies[RIGID_MAX_BODIES];
+
+static int ufParent[RIGID_CELLS];
+static int ufSize[RIGID_CELLS];
+static bool solid[RIGID_CELLS];
+
+// --- UNION-FIND ---
+
+static int Find(int i) {
+    while (ufParent[i] != i) {
+        ufParent[i] = ufParent[ufParent[i]];
+        i = ufParent[i];
+    }
+    return i;
+}
+
+static void Union(int a, int b) {
+    a = Find(a);
+    b = Find(b);
+    if (a == b) return;
+    if (ufSize[a] < ufSize[b]) { int t = a; a = b; b = t; }
+    ufParent[b] = a;
+    ufSize[a] += ufSize[b];
+}
+
+static int Neighbours(int i, int* out) {
+    int x = i % GRID_W, y = i / GRID_W, n = 0;
+    if (x > 0) out[n++] = i - 1;
+    if (x < GRID_W - 1) out[n++] = i + 1;
+    if (y > 0) out[n++] = i - GRID_W;
+    if (y < GRID_H - 1) out[n++] = i + GRID_W;
+    return n;
+}
+
+// --- BODIES ---
+
+static void SpawnBody(const int* cells, int count, Vector2 from) {
+    RigidBody* b = NULL;
+    for (int i = 0; i < RIGID_MAX_BODIES && !b; i++) {
+        if (!bodies[i].active) b = &bodies[i];
+    }
+    if (!b) return; // Too many loose pieces: this one stays where it is
+
+    int minX = GRID_W, minY = GRID_H, maxX = 0, maxY = 0;
+    for (int i = 0; i < count; i++) {
+        int x = cells[i] % GRID_W, y = cells[i] / GRID_W;
+        if (x < minX) minX = x;
+        if (y < minY) minY = y;
+        if (x > maxX) maxX = x;
+        if (y > maxY) maxY = y;
+    }
+
+    b->active = true;
+    b->position = (Vector2){ (float)minX, (float)minY };
+    b->count = count;
+    b->w = maxX - minX + 1;
+    b->h = maxY - minY + 1;
+    for (int i = 0; i < count; i++) {
+        int x = cells[i] % GRID_W, y = cells[i] / GRID_W;
+        Cell c = GetCell(x, y);
+        b->dx[i] = (unsigned char)(x - minX);
+        b->dy[i] = (unsigned char)(y - minY);
+        b->type[i] = (unsigned char)c.type;
+        c.type = BLOCK_AIR;
+        c.life = 0;
+        SetCell(x, y, c);
+        solid[cells[i]] = false;
+    }
+
+    // Knocked away from where the support was removed
+    Vector2 center = { minX + b->w / 2.0f, minY + b->h / 2.0f };
+    Vector2 away = Vector2Subtract(center, from);
+    b->velocity = (Vector2Length(away) > 0) ? Vector2Scale(Vector2Normalize(away), RIGID_KICK) : (Vector2){ 0, 0 };
+    LiveStats.detached++;
+}
+
+static bool BodyHasCell(const RigidBody* b, int ox, int oy, int x, int y) {
+    if (x < ox || y < oy || x >= ox + b->w || y >= oy + b->h) return false;
+    for (int i = 0; i < b->count; i++) {
+        if (ox + b->dx[i] == x && oy + b->dy[i] == y) return true;
+    }
+    return false;
+}
+
+static int CellX(const RigidBody* b) { return (int)floorf(b->position.x + 0.5f); }
+static int CellY(const RigidBody* b) { return (int)floorf(b->position.y + 0.5f); }
+
+// Would body b, with its origin on cell (ox, oy), overlap a wall or another body?
+static bool BodyBlocked(const RigidBody* b, int ox, int oy) {
+    if (ox < 0 || oy < 0 || ox + b->w > GRID_W || oy + b->h > GRID_H) return true;
+    for (int i = 0; i < b->count; i++) {
+        if (IsSolid(GetCellType(ox + b->dx[i], oy + b->dy[i]))) return true;
+    }
+    for (int k = 0; k < RIGID_MAX_BODIES; k++) {
+        const RigidBody* o = &bodies[k];
+        if (!o->active || o == b) continue;
+        int px = CellX(o), py = CellY(o);
+        if (px >= ox + b->w || py >= oy + b->h || px + o->w <= ox || py + o->h <= oy) continue;
+        for (int i = 0; i < b->count; i++) {
+            if (BodyHasCell(o, px, py, ox + b->dx[i], oy + b->dy[i])) return true;
+        }
+    }
+    return false;
+}
+
+static bool BodyTouchesGround(const RigidBody* b) {
+    int ox = CellX(b), oy = CellY(b);
+    static const int dx[4] = { -1, 1, 0, 0 }, dy[4] = { 0, 0, -1, 1 };
+    for (int i = 0; i < b->count; i++) {
+        for (int d = 0; d < 4; d++) {
+            int x = ox + b->dx[i] + dx[d], y = oy + b->dy[i] + dy[d];
+            if (IsValid(x, y) && IsSolid(GetCellType(x, y))) return true;
+        }
+    }
+    return false;
+}
+
+// Is (x, y) under any sliding body (including one about to weld)?
+static bool CoveredByBody(int x, int y) {
+    for (int k = 0; k < RIGID_MAX_BODIES; k++) {
+        const RigidBody* o = &bodies[k];
+        if (o->active && BodyHasCell(o, CellX(o), CellY(o), x, y)) return true;
+    }
+    return false;
+}
+
+// Bodies slide through water and lava (BodyBlocked only stops at solids), so
+// one can rest on fluid. Before the weld covers it, the fluid moves to the
+// nearest empty cell in its column (above wins a tie). If the column is full
+// it is lost.
+static void DisplaceFluid(int x, int y) {
+    Cell fluid = GetCell(x, y);
+    for (int dist = 1; dist < GRID_H; dist++) {
+        int tries[2] = { y - dist, y + dist };
+        for (int t = 0; t < 2; t++) {
+            int ty = tries[t];
+            if (ty < 0 || ty >= GRID_H || GetCellType(x, ty) != BLOCK_AIR || CoveredByBody(x, ty)) continue;
+            Cell c = GetCell(x, ty);
+            c.type = fluid.type;
+            c.life = fluid.life;
+            c.active = true;
+            SetCell(x, ty, c);
+            return;
+        }
+    }
+}
+
+// Writes the body back into the grid where it rests
+static void WeldBody(RigidBody* b) {
+    int ox = CellX(b), oy = CellY(b);
+    for (int i = 0; i < b->count; i++) {
+        int x = ox + b->dx[i], y = oy + b->dy[i];
+        if (IsFluid(GetCellType(x, y))) DisplaceFluid(x, y);
+        Cell c = GetCell(x, y);
+        c.type = (BlockType)b->type[i];
+        c.life = 0;
+        c.active = true;
+        SetCell(x, y, c);
+    }
+    b->active = false;
+}
+
+// Moves one axis at most a cell per step; stops at the first obstacle
+static void MoveAxis(RigidBody* b, float* pos, float* vel) {
+    float delta = *vel * RIGID_DT;
+    int steps = (int)ceilf(fabsf(delta));
+    for (int i = 0; i < steps; i++) {
+        float old = *pos;
+        *pos += delta / steps;
+        if (BodyBlocked(b, CellX(b), CellY(b))) {
+            *pos = old;
+            *vel = 0;
+            return;
+        }
+    }
+}
+
+void UpdateRigidBodies() {
+    for (int k = 0; k < RIGID_MAX_BODIES; k++) {
+        RigidBody* b = &bodies[k];
+        if (!b->active) continue;
+
+        MoveAxis(b, &b->position.x, &b->velocity.x);
+        MoveAxis(b, &b->position.y, &b->velocity.y);
+        b->velocity = Vector2Scale(b->velocity, RIGID_FRICTION);
+
+        if (Vector2Length(b->velocity) < RIGID_REST_SPEED) {
+            b->velocity = (Vector2){ 0, 0 };
+            b->position = (Vector2){ (float)CellX(b), (float)CellY(b) }; // Settle on whole cells
+            if (BodyTouchesGround(b)) WeldBody(b);
+        }
+    }
+}
+
+// Player (or anything round) moving into bodies: true if pos overlaps one.
+// Overlapped bodies are shoved along `velocity` (pixels/s); big ones move slower.
+bool PushRigidBodies(Vector2 pos, float radius, Vector2 velocity) {
+    bool hit = false;
+    for (int k = 0; k < RIGID_MAX_BODIES; k++) {
+        RigidBody* b = &bodies[k];
+        if (!b->active) continue;
+        Rectangle box = { b->position.x * CELL_SIZE, b->position.y * CELL_SIZE, b->w * CELL_SIZE, b->h * CELL_SIZE };
+        if (!CheckCollisionCircleRec(pos, radius, box)) continue;
+
+        bool overlap = false;
+        for (int i = 0; i < b->count && !overlap; i++) {
+            Rectangle cell = { (b->position.x + b->dx[i]) * CELL_SIZE, (b->position.y + b->dy[i]) * CELL_SIZE, CELL_SIZE, CELL_SIZE };
+            overlap = CheckCollisionCircleRec(pos, radius, cell);
+        }
+        if (!overlap) continue;
+
+        hit = true;
+        float share = (b->count <= RIGID_PUSH_CELLS) ? 1.0f : RIGID_PUSH_CELLS / b->count;
+        Vector2 push = Vector2Scale(velocity, share / CELL_SIZE);
+        if (fabsf(push.x) > fabsf(b->velocity.x)) b->velocity.x = push.x;
+        if (fabsf(push.y) > fabsf(b->velocity.y)) b->velocity.y = push.y;
+    }
+    return hit;
+}
+
+void DrawRigidBodies() {
+    for (int k = 0; k < RIGID_MAX_BODIES; k++) {
+        RigidBody* b = &bodies[k];
+        if (!b->active) continue;
+        for (int i = 0; i < b->count; i++) {
+            // Color noise follows the body, not the grid, so it doesn't shimmer as it slides
+            Color color = GetBlockColorAt((BlockType)b->type[i], b->dx[i], b->dy[i]);
+            DrawRectangleV((Vector2){ (b->position.x + b->dx[i]) * CELL_SIZE, (b->position.y + b->dy[i]) * CELL_SIZE },
+                           (Vector2){ CELL_SIZE, CELL_SIZE }, color);
+        }
+    }
+}
+
+int GetRigidBodyCount() {
+    int count = 0;
+    for (int k = 0; k < RIGID_MAX_BODIES; k++) count += bodies[k].active;
+    return count;
+}
+
+void ClearRigidBodies() {
+    for (int k = 0; k < RIGID_MAX_BODIES; k++) bodies[k].active = false;
+}
+
+// --- SAVE / LOAD (for the rewind history) ---
+// A body's cells are AIR in the grid while it slides, so the history stores
+// the bodies next to every record: [count] then per body position, velocity
+// (raw floats), [cells] and (dx, dy, type) per cell. At most RIGID_SAVE_MAX_BYTES.
+
+static int WriteFloat(unsigned char* out, float f) { memcpy(out, &f, sizeof(float)); return sizeof(float); }
+static int ReadFloat(const unsigned char* in, float* f) { memcpy(f, in, sizeof(float)); return sizeof(float); }
+
+int SaveRigidBodies(unsigned char* out) {
+    int n = 1;
+    out[0] = 0;
+    for (int k = 0; k < RIGID_MAX_BODIES; k++) {
+        const RigidBody* b = &bodies[k];
+        if (!b->active) continue;
+        out[0]++;
+        n += WriteFloat(out + n, b->position.x);
+        n += WriteFloat(out + n, b->position.y);
+        n += WriteFloat(out + n, b->velocity.x);
+        n += WriteFloat(out + n, b->velocity.y);
+        n += WriteVarint(out + n, (unsigned int)b->count);
+        for (int i = 0; i < b->count; i++) {
+            out[n++] = b->dx[i];
+            out[n++] = b->dy[i];
+            out[n++] = b->type[i];
+        }
+    }
+    return n;
+}
+
+// Replaces every body with the ones saved at in
+int LoadRigidBodies(const unsigned char* in) {
+    ClearRigidBodies();
+    int n = 1;
+    for (int k = 0; k < in[0]; k++) {
+        RigidBody* b = &bodies[k];
+        unsigned int count;
+        n += ReadFloat(in + n, &b->position.x);
+        n += ReadFloat(in + n, &b->position.y);
+        n += ReadFloat(in + n, &b->velocity.x);
+        n += ReadFloat(in + n, &b->velocity.y);
+        n += ReadVarint(in + n, &count);
+        b->active = true;
+        b->count = (int)count;
+        b->w = b->h = 0;
+        for (int i = 0; i < b->count; i++) {
+            b->dx[i] = in[n++];
+            b->dy[i] = in[n++];
+            b->type[i] = in[n++];
+            if (b->dx[i] + 1 > b->w) b->w = b->dx[i] + 1;
+            if (b->dy[i] + 1 > b->h) b->h = b->dy[i] + 1;
+        }
+    }
+    return n;
+}
+
+// --- SPLIT DETECTION ---
+
+typedef struct {
+    int group;                       // Searches that met share a group
+    int head, tail;
+    int cells[RIGID_MAX_CELLS + 4];  // BFS queue; [0, tail) are the cells it claimed
+} Search;
+
+static Search searches[RIGID_MAX_SEEDS];
+static int markStamp[RIGID_CELLS];   // == splitStamp: claimed by search markId this run
+static unsigned short markId[RIGID_CELLS];
+static int splitStamp = 0;
+
+static int GroupOf(int s) {
+    while (searches[s].group != s) s = searches[s].group;
+    return s;
+}
+
+// Runs the searches from seeds (all in one union-find set) and detaches
+// every piece that came loose.
+static void FindSplits(const int* seeds, int count, Vector2 from) {
+    if (count < 2) return; // One neighbour left: nothing to split from
+    splitStamp++;
+    int groupCells[RIGID_MAX_SEEDS];
+    for (int s = 0; s < count; s++) {
+        Search* sr = &searches[s];
+        sr->group = s;
+        sr->head = 0;
+        sr->tail = 0;
+        markStamp[seeds[s]] = splitStamp;
+        markId[seeds[s]] = (unsigned short)s;
+        sr->cells[sr->tail++] = seeds[s];
+        groupCells[s] = 1;
+    }
+    // Seeds are distinct (RigidCommitTick dedupes them), so each starts its own group
+
+    // Take turns until at most one group can still turn out to be a loose piece
+    for (;;) {
+        int exploring = 0, large = 0;
+        bool open[RIGID_MAX_SEEDS] = { 0 };
+        for (int s = 0; s < count; s++) {
+            int g = GroupOf(s);
+            if (searches[s].head < searches[s].tail) open[g] = true;
+        }
+        for (int g = 0; g < count; g++) {
+            if (GroupOf(g) != g) continue;
+            if (groupCells[g] > RIGID_MAX_CELLS) large++;
+            else if (open[g]) exploring++;
+        }
+        if (!(exploring >= 2 || (exploring == 1 && large >= 1))) break;
+
+        for (int s = 0; s < count; s++) {
+            Search* sr = &searches[s];
+            int g = GroupOf(s);
+            if (sr->head == sr->tail || groupCells[g] > RIGID_MAX_CELLS) continue;
+
+            int around[4];
+            int n = Neighbours(sr->cells[sr->head++], around);
+            for (int k = 0; k < n; k++) {
+                int c = around[k];
+                if (!solid[c]) continue;
+                if (markStamp[c] == splitStamp) {
+                    int other = GroupOf(markId[c]);
+                    if (other != g) { // Met another search: same piece after all
+                        searches[other].group = g;
+                        groupCells[g] += groupCells[other];
+                    }
+                    continue;
+                }
+                if (groupCells[g] > RIGID_MAX_CELLS || sr->tail == RIGID_MAX_CELLS + 4) {
+                    groupCells[g] = RIGID_MAX_CELLS + 1; // Too big to be loose
+                    break;
+                }
+                markStamp[c] = splitStamp;
+                markId[c] = (unsigned short)s;
+                sr->cells[sr->tail++] = c;
+                groupCells[g]++;
+            }
+        }
+    }
+
+    // Pieces that ran out of cells are loose, unless nothing bigger is left
+    // (a lone rock broken in two keeps its biggest half in place)
+    int finished[RIGID_MAX_SEEDS], finishedCount = 0, keep = -1;
+    bool anyOpen = false;
+    for (int g = 0; g < count; g++) {
+        if (GroupOf(g) != g) continue;
+        bool open = groupCells[g] > RIGID_MAX_CELLS;
+        for (int s = 0; s < count && !open; s++) {
+            open = GroupOf(s) == g && searches[s].head < searches[s].tail;
+        }
+        if (open) anyOpen = true;
+        else finished[finishedCount++] = g;
+    }
+    if (!anyOpen) {
+        for (int i = 0; i < finishedCount; i++) {
+            if (keep < 0 || groupCells[finished[i]] > groupCells[keep]) keep = finished[i];
+        }
+    }
+
+    static int piece[RIGID_MAX_SEEDS * (RIGID_MAX_CELLS + 4)];
+    for (int i = 0; i < finishedCount; i++) {
+        int g = finished[i];
+        if (g == keep || groupCells[g] < RIGID_MIN_CELLS) continue;
+        int n = 0;
+        for (int s = 0; s < count; s++) {
+            if (GroupOf(s) != g) continue;
+            memcpy(piece + n, searches[s].cells, searches[s].tail * sizeof(int));
+            n += searches[s].tail;
+        }
+        SpawnBody(piece, n, from);
+    }
+}
+
+static int CompareRoots(const void* a, const void* b) {
+    int ra = Find(*(const int*)a), rb = Find(*(const int*)b);
+    return (ra > rb) - (ra < rb);
+}
+
+// Called once per committed tick with every cell that may have changed
+void RigidCommitTick(const int* changed, int count) {
+    static int placed[RIGID_CELLS], removed[RIGID_CELLS];
+    int placedCount = 0, removedCount = 0;
+    for (int i = 0; i < count; i++) {
+        int cell = changed[i];
+        bool s = IsSolid(GetCellType(cell % GRID_W, cell / GRID_W));
+        if (s == solid[cell]) continue;
+        solid[cell] = s;
+        if (s) placed[placedCount++] = cell;
+        else removed[removedCount++] = cell;
+    }
+
+    int around[4];
+    for (int i = 0; i < placedCount; i++) {
+        int n = Neighbours(placed[i], around);
+        for (int k = 0; k < n; k++) {
+            if (solid[around[k]]) Union(placed[i], around[k]);
+        }
+    }
+    if (removedCount == 0) return;
+
+    // Solid cells next to the holes, each once, grouped by set
+    static int seeds[RIGID_CELLS];
+    int seedCount = 0;
+    Vector2 from = { 0, 0 };
+    splitStamp++;
+    for (int i = 0; i < removedCount; i++) {
+        from.x += removed[i] % GRID_W;
+        from.y += removed[i] / GRID_W;
+        int n = Neighbours(removed[i], around);
+        for (int k = 0; k < n; k++) {
+            int c = around[k];
+            if (!solid[c] || markStamp[c] == splitStamp) continue;
+            markStamp[c] = splitStamp;
+            seeds[seedCount++] = c;
+        }
+    }
+    from = Vector2Scale(from, 1.0f / removedCount);
+    qsort(seeds, seedCount, sizeof(int), CompareRoots);
+
+    for (int start = 0; start < seedCount;) {
+        int root = Find(seeds[start]), end = start;
+        while (end < seedCount && Find(seeds[end]) == root) end++;
+        // A huge edit can touch more seeds than we track; those places just stay put
+        if (end - start <= RIGID_MAX_SEEDS) FindSplits(seeds + start, end - start, from);
+        start = end;
+    }
+}
+
+// New map: one full pass to build the sets, then only local work from here on
+void ResetRigidBodies() {
+    TrackStatic(MEM_ENTITIES, "rigid bodies", sizeof(bodies));
+    TrackStatic(MEM_WORLD, "integrity", sizeof(ufParent) + sizeof(ufSize) + sizeof(solid) + sizeof(searches) + sizeof(markStamp) + sizeof(markId));
+    ClearRigidBodies();
+    for (int i = 0; i < RIGID_CELLS; i++) {
+        ufParent[i] = i;
+        ufSize[i] = 1;
+        solid[i] = IsSolid(GetCellType(i % GRID_W, i / GRID_W));
+    }
+    for (int i = 0; i < RIGID_CELLS; i++) {
+        if (!solid[i]) continue;
+        if (i % GRID_W < GRID_W - 1 && solid[i + 1]) Union(i, i + 1);
+        if (i / GRID_W < GRID_H - 1 && solid[i + GRID_W]) Union(i, i + GRID_W);
+    }
+}
@@ -0,0 +1,108 @@
+#include "game.h"
+#include <string.h>
+
+// --- SIMULATION STATS ---
+// physics.c bumps the counters in LiveStats directly while it works (plain
+// int increments, nothing else on the hot path). Once per tick CommitStats()
+// copies them into a ring of the last STATS_HISTORY ticks for the debug panel
+// and, if a dump file is open, appends them there as one row per tick.
+//
+// The dump format follows the file extension: ".csv" gets a header plus one
+// CSV row per tick, anything else gets one JSON object per line.
+
+TickStats LiveStats;
+
+static TickStats ring[STATS_HISTORY];
+static int ringHead = 0;  // Next slot to write
+static int ringCount = 0;
+static unsigned int statsTick = 0;
+
+static FILE* dumpFile = NULL;
+static bool dumpCsv = false;
+static TickStats pending[STATS_DUMP_INTERVAL]; // Written out in one go every interval
+static int pendingCount = 0;
+
+static int TotalMoved(const TickStats* s) {
+    int total = 0;
+    for (int t = 0; t < BLOCK_COUNT; t++) total += s->moved[t];
+    return total;
+}
+
+static void WriteRow(const TickStats* s, unsigned int tick) {
+    if (dumpCsv) {
+        fprintf(dumpFile, "%u,%.3f,%.3f,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d", tick, s->frameMs, s->tickMs,
+                s->visited, s->active, TotalMoved(s), s->reactions, s->ignitions, s->settled, s->edited, s->relit, s->navRebuilt, s->detached);
+        for (int t = 0; t < BLOCK_COUNT; t++) fprintf(dumpFile, ",%d", s->moved[t]);
+        fprintf(dumpFile, "\n");
+        return;
+    }
+    fprintf(dumpFile, "{\"tick\": %u, \"frame_ms\": %.3f, \"tick_ms\": %.3f, \"visited\": %d, \"active\": %d, "
+            "\"reactions\": %d, \"ignitions\": %d, \"settled\": %d, \"edited\": %d, \"relit\": %d, \"nav_rebuilt\": %d, \"detached\": %d, \"moved\": {",
+            tick, s->frameMs, s->tickMs, s->visited, s->active, s->reactions, s->ignitions, s->settled, s->edited, s->relit, s->navRebuilt, s->detached);
+    for (int t = 0; t < BLOCK_COUNT; t++) {
+        fprintf(dumpFile, "%s\"%s\": %d", t ? ", " : "", BlockNames[t], s->moved[t]);
+    }
+    fprintf(dumpFile, "}}\n");
+}
+
+static void FlushDump() {
+    if (!dumpFile) return;
+    unsigned int first = statsTick - pendingCount + 1;
+    for (int i = 0; i < pendingCount; i++) WriteRow(&pending[i], first + i);
+    fflush(dumpFile);
+    pendingCount = 0;
+}
+
+bool StartStatsDump(const char* path) {
+    dumpFile = fopen(path, "w");
+    if (!dumpFile) return false;
+
+    const char* ext = strrchr(path, '.');
+    dumpCsv = ext && strcmp(ext, ".csv") == 0;
+    if (dumpCsv) {
+        fprintf(dumpFile, "tick,frame_ms,tick_ms,visited,active,moved,reactions,ignitions,settled,edited,relit,nav_rebuilt,detached");
+        for (int t = 0; t < BLOCK_COUNT; t++) fprintf(dumpFile, ",moved_%s", BlockNames[t]);
+        fprintf(dumpFile, "\n");
+    }
+    return true;
+}
+
+void StopStatsDump() {
+    if (!dumpFile) return;
+    FlushDump();
+    fclose(dumpFile);
+    dumpFile = NULL;
+}
+
+// Called once per committed world tick. tickMs is how long UpdateWorld took.
+void CommitStats(float tickMs) {
+    statsTick++;
+    if (statsTick == 1) TrackStatic(MEM_UI, "stats", sizeof(ring) + sizeof(pending));
+    LiveStats.tickMs = tickMs;
+    LiveStats.frameMs = GetFrameTime() * 1000.0f;
+
+    ring[ringHead] = LiveStats;
+    ringHead = (ringHead + 1) % STATS_HISTORY;
+    if (ringCount < STATS_HISTORY) ringCount++;
+
+    if (dumpFile) {
+        pending[pendingCount++] = LiveStats;
+        if (pendingCount == STATS_DUMP_INTERVAL) FlushDump();
+    }
+
+    memset(&LiveStats, 0, sizeof(LiveStats));
+}
+
+// Stats of the tick `ago` ticks back (0 = last committed), NULL if not recorded
+const TickStats* GetTickStats(int ago) {
+    if (ago < 0 || ago >= ringCount) return NULL;
+    return &ring[(ringHead - 1 - ago + STATS_HISTORY) % STATS_HISTORY];
+}
+
+int GetStatsTickCount() {
+    return ringCount;
+}
+
+int GetMovedTotal(const TickStats* s) {
+    return TotalMoved(s);
+}
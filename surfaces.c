@@ -0,0 +1,208 @@
+#include "game.h"
+#include "rlgl.h"
+#include <string.h>
+
+// --- SURFACES (MARCHING SQUARES) ---
+// Water and lava are drawn as smooth shapes, and every solid and fluid gets a
+// contour line, instead of blocky cells and per-cell outline rectangles.
+//
+// For each material we sample "is this cell that material" at cell centers.
+// Each square between four neighbouring centers looks up one of 16 cases and
+// emits a convex polygon (fluids only) and the contour segment through the
+// midpoints of its edges. So straight walls follow cell borders, and corners
+// are cut at 45 degrees.
+//
+// The meshes are cached per chunk. CommitTick reports the changed cells, and
+// only the chunks where a cell changed material (or the chunks whose squares
+// sample that cell) are rebuilt, on the next draw. Each frame then draws all
+// cached triangles and all lines in two batches.
+
+#define SURF_CHUNKS (CHUNKS_X * CHUNKS_Y)
+
+typedef struct {
+    float x, y;          // In cells
+    unsigned char type;  // BlockType
+} SurfaceVertex;
+
+typedef struct {
+    SurfaceVertex* verts;
+    int count, capacity;
+} VertexList;
+
+typedef struct {
+    bool dirty;
+    VertexList fill;   // Triangles (3 vertices each)
+    VertexList lines;  // Segments (2 vertices each)
+} SurfaceChunk;
+
+static SurfaceChunk surfaces[SURF_CHUNKS];
+static unsigned char surfaceType[GRID_W * GRID_H]; // Material the meshes were built from (BLOCK_AIR = none)
+
+// Corners and edge midpoints of a square, in the order used by the tables
+enum { TL, TR, BR, BL, MT, MR, MB, ML };
+static const float pointX[8] = { 0, 1, 1, 0, 0.5f, 1, 0.5f, 0 };
+static const float pointY[8] = { 0, 0, 1, 1, 0, 0.5f, 1, 0.5f };
+
+// Case = TL << 3 | TR << 2 | BR << 1 | BL. Polygons go clockwise on screen.
+// Both saddles (5, 10) join their corners, which reads better for liquids.
+static const signed char casePolygon[16][7] = {
+    { 0 },
+    { 3, ML, MB, BL },
+    { 3, MB, MR, BR },
+    { 4, ML, MR, BR, BL },
+    { 3, MT, TR, MR },
+    { 6, MT, TR, MR, MB, BL, ML },
+    { 4, MT, TR, BR, MB },
+    { 5, MT, TR, BR, BL, ML },
+    { 3, TL, MT, ML },
+    { 4, TL, MT, MB, BL },
+    { 6, TL, MT, MR, BR, MB, ML },
+    { 5, TL, MT, MR, BR, BL },
+    { 4, TL, TR, MR, ML },
+    { 5, TL, TR, MR, MB, BL },
+    { 5, TL, TR, BR, MB, ML },
+    { 4, TL, TR, BR, BL },
+};
+
+// Contour segments: count, then pairs of points
+static const signed char caseLines[16][5] = {
+    { 0 }, { 1, ML, MB }, { 1, MB, MR }, { 1, ML, MR },
+    { 1, MT, MR }, { 2, MR, MB, ML, MT }, { 1, MT, MB }, { 1, MT, ML },
+    { 1, MT, ML }, { 1, MT, MB }, { 2, MT, MR, MB, ML }, { 1, MT, MR },
+    { 1, ML, MR }, { 1, MR, MB }, { 1, MB, ML }, { 0 },
+};
+
+// Materials that get a contour (fluids are also filled)
+static BlockType SurfaceMaterial(BlockType t) {
+    return (IsSolid(t) || IsFluid(t)) ? t : BLOCK_AIR;
+}
+
+static void Push(VertexList* list, float x, float y, BlockType type) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 256;
+        list->verts = TagRealloc(MEM_RENDER, list->verts, list->capacity * sizeof(SurfaceVertex));
+    }
+    // Squares on the map edge reach half a cell past it
+    x = Clamp(x, 0.0f, (float)GRID_W);
+    y = Clamp(y, 0.0f, (float)GRID_H);
+    list->verts[list->count++] = (SurfaceVertex){ x, y, (unsigned char)type };
+}
+
+// Material at (x, y), with the map edge repeated outwards
+static BlockType Sample(int x, int y) {
+    x = (x < 0) ? 0 : (x >= GRID_W) ? GRID_W - 1 : x;
+    y = (y < 0) ? 0 : (y >= GRID_H) ? GRID_H - 1 : y;
+    return (BlockType)surfaceType[y * GRID_W + x];
+}
+
+static void BuildChunk(int chunk) {
+    SurfaceChunk* s = &surfaces[chunk];
+    s->fill.count = 0;
+    s->lines.count = 0;
+    s->dirty = false;
+
+    int x0 = (chunk % CHUNKS_X) * CHUNK_SIZE, y0 = (chunk / CHUNKS_X) * CHUNK_SIZE;
+    int x1 = (x0 + CHUNK_SIZE < GRID_W) ? x0 + CHUNK_SIZE : GRID_W;
+    int y1 = (y0 + CHUNK_SIZE < GRID_H) ? y0 + CHUNK_SIZE : GRID_H;
+
+    // The square with top-left center (sx, sy) belongs to the chunk of that
+    // cell; the first row and column also get the half squares on the map edge
+    for (int sy = (y0 == 0) ? -1 : y0; sy < y1; sy++) {
+        for (int sx = (x0 == 0) ? -1 : x0; sx < x1; sx++) {
+            BlockType corner[4] = { Sample(sx, sy), Sample(sx + 1, sy), Sample(sx + 1, sy + 1), Sample(sx, sy + 1) };
+            for (int k = 0; k < 4; k++) {
+                BlockType m = corner[k];
+                if (m == BLOCK_AIR) continue;
+                bool seen = false; // Each material once per square
+                for (int j = 0; j < k; j++) seen |= corner[j] == m;
+                if (seen) continue;
+
+                int code = ((corner[0] == m) << 3) | ((corner[1] == m) << 2) | ((corner[2] == m) << 1) | (corner[3] == m);
+                float ox = sx + 0.5f, oy = sy + 0.5f;
+
+                const signed char* line = caseLines[code];
+                for (int i = 0; i < line[0]; i++) {
+                    int a = line[1 + 2 * i], b = line[2 + 2 * i];
+                    Push(&s->lines, ox + pointX[a], oy + pointY[a], m);
+                    Push(&s->lines, ox + pointX[b], oy + pointY[b], m);
+                }
+
+                if (!IsFluid(m)) continue;
+                // Fan, emitted counter-clockwise like raylib's own shapes
+                const signed char* poly = casePolygon[code];
+                for (int i = 2; i < poly[0]; i++) {
+                    Push(&s->fill, ox + pointX[poly[1]], oy + pointY[poly[1]], m);
+                    Push(&s->fill, ox + pointX[poly[i + 1]], oy + pointY[poly[i + 1]], m);
+                    Push(&s->fill, ox + pointX[poly[i]], oy + pointY[poly[i]], m);
+                }
+            }
+        }
+    }
+}
+
+// Marks every chunk with a square that samples cell (x, y)
+static void MarkDirty(int x, int y) {
+    int cx = x / CHUNK_SIZE, cy = y / CHUNK_SIZE;
+    bool left = (x % CHUNK_SIZE == 0) && cx > 0; // Squares of the chunk to the left reach into this column
+    bool up = (y % CHUNK_SIZE == 0) && cy > 0;
+    surfaces[cy * CHUNKS_X + cx].dirty = true;
+    if (left) surfaces[cy * CHUNKS_X + cx - 1].dirty = true;
+    if (up) surfaces[(cy - 1) * CHUNKS_X + cx].dirty = true;
+    if (left && up) surfaces[(cy - 1) * CHUNKS_X + cx - 1].dirty = true;
+}
+
+// New map: every chunk is rebuilt on the next draw
+void ResetSurfaces() {
+    TrackStatic(MEM_RENDER, "surfaces", sizeof(surfaces) + sizeof(surfaceType));
+    for (int i = 0; i < GRID_W * GRID_H; i++) surfaceType[i] = (unsigned char)SurfaceMaterial(GetCellType(i % GRID_W, i / GRID_W));
+    for (int c = 0; c < SURF_CHUNKS; c++) surfaces[c].dirty = true;
+}
+
+// Called once per committed tick with every cell that may have changed
+void SurfaceCommitTick(const int* changed, int count) {
+    for (int i = 0; i < count; i++) {
+        int cell = changed[i];
+        int x = cell % GRID_W, y = cell / GRID_W;
+        unsigned char m = (unsigned char)SurfaceMaterial(GetCellType(x, y));
+        if (m == surfaceType[cell]) continue; // Life, floor or a non-surface material
+        surfaceType[cell] = m;
+        MarkDirty(x, y);
+    }
+}
+
+static Color VertexColor(const SurfaceVertex* v, bool line) {
+    int x = (int)v->x, y = (int)v->y;
+    x = (x >= GRID_W) ? GRID_W - 1 : x;
+    y = (y >= GRID_H) ? GRID_H - 1 : y;
+    BlockType t = (BlockType)v->type;
+    if (line) {
+        // Walls get the old dark outline, liquids a bright rim
+        return IsFluid(t) ? Fade(WHITE, (t == BLOCK_LAVA) ? 0.45f : 0.3f) : Fade(BLACK, 0.5f);
+    }
+    Color c = GetBlockColorAt(t, x, y);
+    if (Materials[t].emitLight > 0) return c;
+    float brightness = LIGHT_AMBIENT + (1.0f - LIGHT_AMBIENT) * GetLight(x, y) / LIGHT_MAX;
+    return (Color){ (unsigned char)(c.r * brightness), (unsigned char)(c.g * brightness), (unsigned char)(c.b * brightness), c.a };
+}
+
+static void DrawList(const VertexList* list, int mode, bool line) {
+    if (list->count == 0) return;
+    rlCheckRenderBatchLimit(list->count);
+    rlBegin(mode);
+    for (int i = 0; i < list->count; i++) {
+        const SurfaceVertex* v = &list->verts[i];
+        Color c = VertexColor(v, line);
+        rlColor4ub(c.r, c.g, c.b, c.a);
+        rlVertex2f(v->x * CELL_SIZE, v->y * CELL_SIZE);
+    }
+    rlEnd();
+}
+
+// Rebuilds the dirty chunks, then draws fills and contours (called by DrawWorld)
+void DrawSurfaces() {
+    for (int c = 0; c < SURF_CHUNKS; c++) {
+        if (surfaces[c].dirty) BuildChunk(c);
+    }
+    for (int c = 0; c < SURF_CHUNKS; c++) DrawList(&surfaces[c].fill, RL_TRIANGLES, false);
+    for (int c = 0; c < SURF_CHUNKS; c++) DrawList(&surfaces[c].lines, RL_LINES, true);
+}
@@ -27,5 +27,92 @@ void DrawHUD(Player* p, Inventory* inv) {
     }
     
     DrawText(TextFormat("Selected: %s", BlockNames[inv->slots[inv->selected]]), 20, 20, 20, WHITE);
-    DrawText("L-Click: Mine | R-Click: Place | R: Reset", 20, 50, 10, LIGHTGRAY);
-}
\ No newline at end of file
+    DrawText("L-Click: Mine | R-Click: Place | R: Reset | Z: Rewind | F3: Stats | F4: Paths | F5: Memory", 20, 50, 10, LIGHTGRAY);
+    DrawText(TextFormat("History: %.1fs (%d KB)", GetHistoryTicks() / 60.0f, GetHistoryBytes() / 1024), 20, 65, 10, LIGHTGRAY);
+    if (IsReplicating()) DrawText(TextFormat("Replication: %d B/tick", GetReplicationBytes()), 20, 80, 10, LIGHTGRAY);
+}
+// --- DEBUG PANEL (F3) ---
+
+// One bar per recorded tick, oldest on the left, scaled to the window's peak
+static void DrawHistogram(int x, int y, int w, int h, const char* label, int (*value)(const TickStats*), Color color) {
+    int count = GetStatsTickCount();
+    int peak = 1;
+    for (int i = 0; i < count; i++) {
+        int v = value(GetTickStats(i));
+        if (v > peak) peak = v;
+    }
+
+    DrawRectangle(x, y, w, h, Fade(BLACK, 0.5f));
+    float barW = (float)w / STATS_HISTORY;
+    for (int i = 0; i < count; i++) {
+        int barH = value(GetTickStats(i)) * h / peak;
+        DrawRectangle(x + w - (int)((i + 1) * barW), y + h - barH, (int)barW + 1, barH, color);
+    }
+    DrawText(TextFormat("%s (peak %d)", label, peak), x + 4, y + 2, 10, WHITE);
+}
+
+static int StatMoved(const TickStats* s) { return GetMovedTotal(s); }
+static int StatReactions(const TickStats* s) { return s->reactions; }
+static int StatTickUs(const TickStats* s) { return (int)(s->tickMs * 1000.0f); }
+
+void DrawStatsPanel() {
+    const TickStats* s = GetTickStats(0);
+    if (!s) return;
+
+    int x = SCREEN_WIDTH - 230, y = 20, w = 210;
+    DrawRectangle(x - 5, y - 5, w + 10, 355, Fade(BLACK, 0.6f));
+
+    DrawText(TextFormat("Tick: %.2f ms   Frame: %.1f ms", s->tickMs, s->frameMs), x, y, 10, WHITE);
+    DrawText(TextFormat("Visited: %d  Active: %.1f%%", s->visited, 100.0f * s->active / (GRID_W * GRID_H)), x, y + 15, 10, WHITE);
+    DrawText(TextFormat("Reactions: %d  Ignitions: %d", s->reactions, s->ignitions), x, y + 30, 10, WHITE);
+    DrawText(TextFormat("Settled: %d  Edited: %d  Relit: %d", s->settled, s->edited, s->relit), x, y + 45, 10, WHITE);
+
+    int uniform, palette, full, bytes;
+    GetWorldStorage(&uniform, &palette, &full, &bytes);
+    DrawText(TextFormat("Chunks U/P/F: %d/%d/%d  %d KB", uniform, palette, full, bytes / 1024), x, y + 60, 10, WHITE);
+    DrawText(TextFormat("Nav rebuilt: %d  Loose bodies: %d", s->navRebuilt, GetRigidBodyCount()), x, y + 75, 10, WHITE);
+
+    // Moves this tick, per material
+    int row = y + 92;
+    for (int t = 0; t < BLOCK_COUNT; t++) {
+        if (s->moved[t] == 0) continue;
+        DrawRectangle(x, row, 8, 8, BlockColors[t]);
+        DrawText(TextFormat("%s moved: %d", BlockNames[t], s->moved[t]), x + 12, row, 10, LIGHTGRAY);
+        row += 12;
+    }
+
+    DrawHistogram(x, y + 155, w, 50, "Cells moved", StatMoved, SKYBLUE);
+    DrawHistogram(x, y + 215, w, 50, "Reactions", StatReactions, ORANGE);
+    DrawHistogram(x, y + 275, w, 50, "UpdateWorld (us)", StatTickUs, LIME);
+}
+
+// --- MEMORY PANEL (F5) ---
+
+// Bytes as B / KB / MB, whichever reads best
+static const char* FormatBytes(double bytes) {
+    if (bytes < 1024) return TextFormat("%d B", (int)bytes);
+    if (bytes < 1024 * 1024) return TextFormat("%.1f KB", bytes / 1024);
+    return TextFormat("%.1f MB", bytes / (1024 * 1024));
+}
+
+void DrawMemoryPanel() {
+    int x = 20, y = 100, w = 370;
+    DrawRectangle(x - 5, y - 5, w + 10, 20 + 15 * (MEM_TAG_COUNT + 1), Fade(BLACK, 0.6f));
+
+    static const int columns[] = { 0, 60, 130, 200, 260, 300 };
+    const char* headers[] = { "Tag", "Live", "Peak", "Static", "Allocs", "Rate" };
+    for (int c = 0; c < 6; c++) DrawText(headers[c], x + columns[c], y, 10, LIGHTGRAY);
+
+    for (int t = 0; t < MEM_TAG_COUNT; t++) {
+        const MemoryStats* s = GetMemoryStats((MemTag)t);
+        int row = y + 15 * (t + 1);
+        // Anything allocated every frame is churn: show it in orange
+        Color color = (s->frameAllocs > 0) ? ORANGE : WHITE;
+        DrawText(MemTagNames[t], x + columns[0], row, 10, color);
+        DrawText(FormatBytes((double)s->live), x + columns[1], row, 10, color);
+        DrawText(FormatBytes((double)s->peak), x + columns[2], row, 10, color);
+        DrawText(FormatBytes((double)s->staticBytes), x + columns[3], row, 10, color);
+        DrawText(TextFormat("%d/f", s->frameAllocs), x + columns[4], row, 10, color);
+        DrawText(TextFormat("%s/s", FormatBytes(s->bytesPerSecond)), x + columns[5], row, 10, color);
+    }
+}
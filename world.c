@@ -0,0 +1,163 @@
+#define _POSIX_C_SOURCE 200112L // pthreads and sysconf under -std=c99
+#include "game.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+
+// --- WORLD BATCHES ---
+// Many headless worlds stepped side by side, for level validation and agent
+// training. A batch is one arena (a single allocation holding all of its
+// worlds) and a pool of worker threads.
+//
+// Worlds share nothing they write: each has its own cells, chunk blocks, RNG
+// and counters (see World in game.h), and the material tables are read-only.
+// So the workers need no locks while simulating. They only lock to claim the
+// next world. A claimed world runs all of its ticks in one go, which keeps it
+// in one core's cache.
+//
+// The arena is zeroed by calloc, so pages of a world that are never written (most
+// of its chunk pool) are never touched.
+
+#define ARENA_ALIGN 64 // Cache line: two threads never write the same line
+
+typedef struct {
+    unsigned char* base;
+    size_t size;
+    size_t used;
+} Arena;
+
+typedef enum { JOB_GENERATE, JOB_STEP } BatchJob;
+
+struct WorldBatch {
+    Arena arena;
+    World** worlds;
+    int count;
+    unsigned int seed;
+
+    pthread_t threads[WORLD_MAX_THREADS];
+    int threadCount;
+    pthread_mutex_t lock;
+    pthread_cond_t start;     // A new job was posted
+    pthread_cond_t done;      // The last worker finished it
+    unsigned int generation;  // Bumped per job
+    BatchJob job;
+    int ticks;
+    int next;                 // Next world to claim
+    int busy;                 // Workers still on this job
+    bool quit;
+};
+
+static void* ArenaAlloc(Arena* a, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (a->used + size > a->size) return NULL;
+    void* p = a->base + a->used;
+    a->used += size;
+    return p;
+}
+
+static void RunJob(WorldBatch* b, int i) {
+    World* w = b->worlds[i];
+    if (b->job == JOB_GENERATE) {
+        GenerateWorld(w, b->seed + (unsigned int)i);
+        return;
+    }
+    for (int t = 0; t < b->ticks; t++) StepWorld(w);
+}
+
+static void* Worker(void* arg) {
+    WorldBatch* b = arg;
+    unsigned int seen = 0;
+    pthread_mutex_lock(&b->lock);
+    for (;;) {
+        while (b->generation == seen && !b->quit) pthread_cond_wait(&b->start, &b->lock);
+        if (b->quit) break;
+        seen = b->generation;
+
+        while (b->next < b->count) {
+            int i = b->next++;
+            pthread_mutex_unlock(&b->lock);
+            RunJob(b, i);
+            pthread_mutex_lock(&b->lock);
+        }
+        if (--b->busy == 0) pthread_cond_signal(&b->done);
+    }
+    pthread_mutex_unlock(&b->lock);
+    return NULL;
+}
+
+// Runs job on every world and waits until all are done
+static void Dispatch(WorldBatch* b, BatchJob job, int ticks) {
+    pthread_mutex_lock(&b->lock);
+    b->job = job;
+    b->ticks = ticks;
+    b->next = 0;
+    b->busy = b->threadCount;
+    b->generation++;
+    pthread_cond_broadcast(&b->start);
+    while (b->busy > 0) pthread_cond_wait(&b->done, &b->lock);
+    pthread_mutex_unlock(&b->lock);
+}
+
+// count worlds generated from seed, seed + 1, ... NULL if out of memory.
+// Call InitReactions() first.
+WorldBatch* CreateWorldBatch(int count, int threads, unsigned int seed) {
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads <= 0) threads = 1;
+    if (threads > WORLD_MAX_THREADS) threads = WORLD_MAX_THREADS;
+    if (threads > count) threads = count > 0 ? count : 1;
+
+    WorldBatch* b = TagCalloc(MEM_WORLD, 1, sizeof(WorldBatch));
+    if (!b) return NULL;
+    size_t worldSize = (sizeof(World) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    b->arena.size = worldSize * count + ARENA_ALIGN * 2 + sizeof(World*) * count;
+    b->arena.base = TagCalloc(MEM_WORLD, 1, b->arena.size);
+    if (!b->arena.base) {
+        TagFree(b);
+        return NULL;
+    }
+    // The allocator only promises 16 byte alignment
+    b->arena.used = (size_t)(-(uintptr_t)b->arena.base & (ARENA_ALIGN - 1));
+
+    b->worlds = ArenaAlloc(&b->arena, sizeof(World*) * count);
+    for (int i = 0; i < count; i++) b->worlds[i] = ArenaAlloc(&b->arena, sizeof(World));
+    b->count = count;
+    b->seed = seed;
+
+    pthread_mutex_init(&b->lock, NULL);
+    pthread_cond_init(&b->start, NULL);
+    pthread_cond_init(&b->done, NULL);
+    for (int t = 0; t < threads; t++) {
+        if (pthread_create(&b->threads[t], NULL, Worker, b) != 0) break;
+        b->threadCount++;
+    }
+    if (b->threadCount == 0) {
+        DestroyWorldBatch(b);
+        return NULL;
+    }
+
+    Dispatch(b, JOB_GENERATE, 0);
+    return b;
+}
+
+// Advances every world by ticks ticks
+void StepWorldBatch(WorldBatch* b, int ticks) {
+    Dispatch(b, JOB_STEP, ticks);
+}
+
+World* GetBatchWorld(WorldBatch* b, int i) {
+    return (i >= 0 && i < b->count) ? b->worlds[i] : NULL;
+}
+
+void DestroyWorldBatch(WorldBatch* b) {
+    pthread_mutex_lock(&b->lock);
+    b->quit = true;
+    pthread_cond_broadcast(&b->start);
+    pthread_mutex_unlock(&b->lock);
+    for (int t = 0; t < b->threadCount; t++) pthread_join(b->threads[t], NULL);
+
+    pthread_mutex_destroy(&b->lock);
+    pthread_cond_destroy(&b->start);
+    pthread_cond_destroy(&b->done);
+    TagFree(b->arena.base);
+    TagFree(b);
+}